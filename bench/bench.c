@@ -0,0 +1,81 @@
+// benchmark do simulador: mede separado o carregamento, o pre processamento do otimo e cada politica
+// em varios tamanhos de memoria; grava acessos/s e pico de RSS em csv
+// uso: bench <trace> <nome> <tamanhos> <politicas> <saida.csv> [commit]
+
+#include "simulator.h"
+#include <sys/resource.h>
+
+static long peakRssKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static void record(FILE* out, const char* commit, const char* name, const char* phase, int frames,
+                   double seconds, long long accesses) {
+    double rate = (seconds > 0) ? accesses / seconds : 0.0;
+    long rss = peakRssKb();
+    fprintf(out, "%s,%s,%s,%d,%lld,%.6f,%.0f,%ld\n", commit, name, phase, frames, accesses, seconds, rate, rss);
+    printf("%-8s %-10s %-8d %10.3fs %14.0f acessos/s %10ld KB\n", name, phase, frames, seconds, rate, rss);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 6) {
+        fprintf(stderr, "Uso: %s <trace> <nome> <tamanhos> <politicas> <saida.csv> [commit]\n", argv[0]);
+        return 1;
+    }
+    const char* name = argv[2];
+    const char* commit = (argc > 6) ? argv[6] : "local";
+
+    int* frameCounts = NULL;
+    int numSizes = parseFrameList(argv[3], &frameCounts);
+    const ReplacementPolicy* policies[MAX_POLICIES];
+    int numPolicies = parsePolicyList(argv[4], policies, MAX_POLICIES);
+    if (numSizes < 0 || numPolicies < 0) {
+        fprintf(stderr, "lista de tamanhos ou de políticas inválida.\n");
+        return 1;
+    }
+
+    // acrescenta no csv (cabecalho so se o arquivo for novo)
+    FILE* out = fopen(argv[5], "a+");
+    if (!out) {
+        perror("[ERRO] ao abrir o csv de resultados");
+        return 1;
+    }
+    fseek(out, 0, SEEK_END);
+    if (ftell(out) == 0) fprintf(out, "commit,trace,fase,frames,acessos,segundos,acessos_por_segundo,pico_rss_kb\n");
+
+    hashInit();
+    Trace trace;
+    double start = wallClock();
+    if (loadTrace(argv[1], &trace, 0) != 0) {
+        perror("[ERRO] ao abrir o arquivo.");
+        return 1;
+    }
+    record(out, commit, name, "parse", 0, wallClock() - start, trace.numAccesses);
+
+    int* nextUse = NULL;
+    for (int k = 0; k < numPolicies; k++) {
+        if (policies[k]->needsFuture && !nextUse) {
+            start = wallClock();
+            nextUse = preprocessOptimal(trace.accesses, trace.numAccesses);
+            record(out, commit, name, "preproc", 0, wallClock() - start, trace.numAccesses);
+        }
+    }
+
+    for (int s = 0; s < numSizes; s++) {
+        for (int k = 0; k < numPolicies; k++) {
+            start = wallClock();
+            runPolicySimulation(policies[k], trace.accesses, policies[k]->needsFuture ? nextUse : NULL,
+                                trace.numAccesses, g_pageCount, frameCounts[s], NULL, NULL, 0, NULL);
+            record(out, commit, name, policies[k]->name, frameCounts[s], wallClock() - start, trace.numAccesses);
+        }
+    }
+
+    fclose(out);
+    free(nextUse);
+    free(frameCounts);
+    freeTrace(&trace);
+    cleanHashTable();
+    return 0;
+}
@@ -0,0 +1,99 @@
+// gerador de traces sinteticos p benchmark
+// uso: tracegen <padrao> <acessos> <paginas distintas> [semente] > trace.txt
+// padroes: uniform, zipf, scan, loop, phase
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint64_t rngState;
+
+// xorshift64*: rapido e deterministico pela semente
+static uint64_t nextRandom() {
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return rngState * 2685821657736338717ULL;
+}
+
+static double nextUniform() {
+    return (nextRandom() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// cdf da distribuição de zipf (expoente ~1) sobre n paginas
+static double* zipfTable(int n, double exponent) {
+    double* cdf = (double*)malloc(n * sizeof(double));
+    if (!cdf) {
+        perror("falha ao alocar a tabela de zipf");
+        exit(1);
+    }
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+        sum += 1.0 / pow(i + 1, exponent);
+        cdf[i] = sum;
+    }
+    for (int i = 0; i < n; i++) cdf[i] /= sum;
+    return cdf;
+}
+
+static int zipfSample(const double* cdf, int n) {
+    double u = nextUniform();
+    int lo = 0, hi = n - 1;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (cdf[mid] < u) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// pags do primeiro 1/8 sao de instrução, o resto de dados (mesmo formato "I0"/"D0" dos traces reais)
+static void emit(int page, int numPages) {
+    printf("1 %c%d\n", (page < numPages / 8) ? 'I' : 'D', page);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        fprintf(stderr, "Uso: %s <uniform|zipf|scan|loop|phase> <acessos> <paginas distintas> [semente]\n", argv[0]);
+        return 1;
+    }
+    const char* pattern = argv[1];
+    long long numAccesses = atoll(argv[2]);
+    int numPages = atoi(argv[3]);
+    rngState = (argc > 4) ? strtoull(argv[4], NULL, 10) : 42;
+    if (rngState == 0) rngState = 42;
+    if (numAccesses <= 0 || numPages <= 0) {
+        fprintf(stderr, "acessos e paginas precisam ser positivos.\n");
+        return 1;
+    }
+
+    if (strcmp(pattern, "uniform") == 0) {
+        for (long long i = 0; i < numAccesses; i++) emit((int)(nextRandom() % numPages), numPages);
+    } else if (strcmp(pattern, "zipf") == 0) {
+        double* cdf = zipfTable(numPages, 0.99);
+        for (long long i = 0; i < numAccesses; i++) emit(zipfSample(cdf, numPages), numPages);
+        free(cdf);
+    } else if (strcmp(pattern, "scan") == 0) {
+        // varredura sequencial: cada pag eh acessada varias vezes seguidas e nunca mais
+        for (long long i = 0; i < numAccesses; i++) emit((int)(i * numPages / numAccesses), numPages);
+    } else if (strcmp(pattern, "loop") == 0) {
+        // laço sobre todas as pags: pior caso do lru/fifo quando nao cabe na memoria
+        for (long long i = 0; i < numAccesses; i++) emit((int)(i % numPages), numPages);
+    } else if (strcmp(pattern, "phase") == 0) {
+        // 10 fases; em cada uma o conjunto de trabalho (1/10 das pags) muda e os acessos seguem zipf dentro dele
+        int phaseSize = (numPages / 10 > 0) ? numPages / 10 : 1;
+        double* cdf = zipfTable(phaseSize, 0.99);
+        for (long long i = 0; i < numAccesses; i++) {
+            int phase = (int)(i * 10 / numAccesses);
+            int base = (int)(((long long)phase * phaseSize) % numPages);
+            emit((base + zipfSample(cdf, phaseSize)) % numPages, numPages);
+        }
+        free(cdf);
+    } else {
+        fprintf(stderr, "padrão desconhecido: %s\n", pattern);
+        return 1;
+    }
+    return 0;
+}
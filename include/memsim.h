@@ -0,0 +1,66 @@
+#ifndef MEMSIM_H
+#define MEMSIM_H
+
+// libmemsim: o simulador como biblioteca (lib/libmemsim.a e lib/libmemsim.so)
+// cada contexto tem a propria tabela de paginas e as proprias simulações, e o formato e o tamanho de pag de um
+// trace sao opcoes dele: nada aqui depende das globais do main.exe, entao da p ter varios contextos no mesmo
+// processo (e em threads diferentes, um contexto por thread). a .so so exporta as funções memsim*
+// um trace carregado (MemSimTrace) so eh lido depois da carga e pode ser usado por varios contextos ao mesmo tempo
+// (erros de carga e o aviso de id truncado saem no stderr, como no programa)
+//
+//   MemSimTrace* trace = memsimTraceLoad("acessos.mtr");
+//   MemSim* sim = memsimCreate("otimo,lru", 2048);
+//   memsimAccessTrace(sim, trace);
+//   printf("%lld\n", memsimFaults(sim, 1));
+//   memsimDestroy(sim);
+//   memsimTraceFree(trace);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__GNUC__)
+#define MEMSIM_API __attribute__((visibility("default")))
+#else
+#define MEMSIM_API
+#endif
+
+typedef struct MemSim MemSim;
+typedef struct MemSimTrace MemSimTrace;
+
+// formato das linhas de um trace em texto (como o --format)
+enum { MEMSIM_TRACE_TEXT, MEMSIM_TRACE_LACKEY, MEMSIM_TRACE_PERF };
+
+// policies: mesma lista do --policy ("otimo,fifo,lru,clock,lfu,arc,2q" ou "all"); numFrames >= 1
+// NULL = lista ou tamanho invalido
+MEMSIM_API MemSim* memsimCreate(const char* policies, int numFrames);
+MEMSIM_API void memsimDestroy(MemSim* sim);
+
+// um acesso, varios, ou um trace inteiro ja carregado; 0 = ok, -1 = acessos demais p o otimo guardar
+// ids maiores q 9 caracteres sao truncados, como no trace
+MEMSIM_API int memsimAccess(MemSim* sim, const char* pageId);
+MEMSIM_API int memsimAccessBatch(MemSim* sim, const char* const* pageIds, int count);
+MEMSIM_API int memsimAccessTrace(MemSim* sim, const MemSimTrace* trace);
+
+// resultados: politica = posicao na lista do memsimCreate
+// o otimo precisa do futuro, entao ele so roda (sobre tudo o q ja entrou) na hora da consulta
+MEMSIM_API int memsimPolicyCount(const MemSim* sim);
+MEMSIM_API const char* memsimPolicyName(const MemSim* sim, int policy);
+MEMSIM_API long long memsimFaults(MemSim* sim, int policy); // -1 = politica invalida
+MEMSIM_API long long memsimAccessCount(const MemSim* sim);
+MEMSIM_API int memsimPageCount(const MemSim* sim);          // pags distintas vistas
+
+// trace em texto ou .mtr, lido uma vez e reaproveitado (NULL = erro, com errno)
+MEMSIM_API MemSimTrace* memsimTraceLoad(const char* path);
+// idem com o formato do texto e o tamanho da pag simulada em bytes (como o --page-size: 4KB vezes potencia de 2),
+// q so vale p lackey/perf, onde os ids sao numeros de pag calculados do endereço; EINVAL = combinação invalida
+MEMSIM_API MemSimTrace* memsimTraceLoadFormat(const char* path, int format, long long pageSize);
+MEMSIM_API void memsimTraceFree(MemSimTrace* trace);
+MEMSIM_API long long memsimTraceLength(const MemSimTrace* trace);
+MEMSIM_API int memsimTracePageCount(const MemSimTrace* trace);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -6,56 +6,427 @@
 #include <string.h>
 #include <ctype.h>
 #include <limits.h>
+#include <stdint.h>
 
 #define MAX_PAGE_ID_LEN 10
-#define PAGE_SIZE_BYTES 4096 // tamanho da pag em bytes (4kb)
+#define PAGE_SIZE_BYTES 4096 // tamanho da pag dos ids do trace em bytes (4kb); a simulada eh o g_pageSize
 #define LOG_INTERVAL 50000 // intervalo de logs
 #define DIDATIC_MODE_ACTIVATOR 32768 // limite de memoria p ativar o modo didatico
-#define HASH_TABLE_SIZE 19997
+#define ARENA_CHUNK_SIZE (1 << 20) // tamanho padrao dos blocos da arena (1MB)
+#define HASH_TABLE_INITIAL_SIZE 16384 // capacidade inicial da tabela de paginas (potencia de 2, cresce sozinha)
+#define PAGE_NONE UINT32_MAX // frame vazio / pagina inexistente
+#define STREAM_BUFFER_SIZE (1 << 20) // bytes lidos por vez no modo --stream
+#define STREAM_CHUNK_ACCESSES 65536 // acessos entregues as simulações por bloco no --stream
+#define STREAM_SAMPLE_INTERVAL (1LL << 24) // acessos entre relatorios parciais no --stream (padrao do --report-every)
+#define EXTERNAL_BLOCK_ACCESSES (1 << 20) // acessos por bloco nas passadas do otimo fora da memoria (--stream)
+#define CHECKPOINT_INTERVAL 50000000 // acessos entre checkpoints (padrao do --checkpoint)
+#define WS_SERIES_POINTS 1000 // linhas da serie temporal do --ws
+#define MAX_WS_WINDOWS 8 // taus no --tau
+#define SPLIT_EPOCH 65536 // acessos entre rebalanceamentos dos pools I e D (--split=adaptativo)
+#define SPLIT_STEPS 32 // fatia da memoria q muda de pool a cada rebalanceamento (1/SPLIT_STEPS)
+#define WORKING_SET_WINDOW 10000 // tau do working set W(t, tau) em acessos do processo (--multiprog)
 
 // g para indicar que eh global
 extern int g_verbose; //verbose serve parra ativar logs em tempo real
 extern int g_didaticMode;
 extern int g_pageCount;
+extern long long g_pageSize; // tamanho da pag simulada (--page-size), multiplo de PAGE_SIZE_BYTES
+extern int g_traceFormat; // --format: TRACE_TEXT, TRACE_LACKEY ou TRACE_PERF
+extern int g_stats; // --stats: coleta contadores e tempos (desligado = so um if nos caminhos quentes)
 
 // estrutura para armazenar a seq de acessos
+// guarda so o indice denso da pagina (internado no carregamento), a string fica na tabela hash
 typedef struct {
-    char page_id[MAX_PAGE_ID_LEN];
+    uint32_t page;
 } PageAccess;
 
+enum { TRACE_TEXT, TRACE_LACKEY, TRACE_PERF };
+
+// como as linhas em texto viram ids de pag: o programa monta com o --format e o --page-size,
+// o libmemsim com as opcoes de cada trace (nenhum dos dois le as globais na hora de interpretar)
+typedef struct {
+    int format;    // TRACE_TEXT, TRACE_LACKEY ou TRACE_PERF
+    int pageShift; // log2(pag simulada / 4KB), so nos formatos de tracer
+    int truncated; // ja avisou q truncou id (um aviso por leitura)
+} TraceParser;
+
+// sequencia de acessos carregada do arquivo
+typedef struct {
+    PageAccess* accesses;
+    int numAccesses;
+    int* pids;          // pid de cada acesso (so qdo carregado com keepPids; NULL no resto)
+    void* mapping;      // != NULL quando accesses aponta direto p um trace binario mapeado
+    size_t mappingSize;
+    struct PageTable* pages; // onde os ids sao registrados (NULL = a tabela global)
+    TraceParser parser;
+} Trace;
+
+// leitura do trace em blocos de tamanho fixo (--stream): a memoria nao depende do tamanho do trace
+typedef struct {
+    int fd;
+    char* buffer;
+    size_t start;        // bytes ainda nao consumidos ficam em [start, end)
+    size_t end;
+    int eof;
+    int skipLine;        // linha maior q o buffer: descarta ate o proximo '\n'
+    int binary;          // formato .mtr (dicionario ja registrado na abertura)
+    uint32_t encoding;
+    uint32_t numPages;
+    uint64_t remaining;  // acessos q ainda faltam no .mtr
+    uint64_t sampleThreshold; // so entram pags com hash abaixo disso (amostragem da curva aproximada)
+    uint32_t* remap;     // .mtr amostrado: indice do arquivo -> indice denso (PAGE_NONE = fora da amostra)
+    long long skipped;   // acessos descartados pela amostragem
+    TraceParser parser;
+} TraceReader;
+
 // tabela hash p armazenar paginas e contadores
 typedef struct HashNode {
     char page_id[MAX_PAGE_ID_LEN];
-    int fifoLoads;
-    int optimalLoads;
-    struct HashNode* next;
-    int* futureUses; //array dinamico q guardar os indices dos acessos futuros
-    int numFutureUses;  //qtde de acessos futuros registrados
-    int futureUsesCapacity; // capacidade atual do futureUses
-    int nextUsePointer; // ponteiro p o prox uso a ser considerado
+    uint32_t index; // indice denso da pagina (0..g_pageCount-1)
 } HashNode;
 
-// hash de presença eh usado para verificar se uma pag ta presente na memoria
-typedef struct PresenceNode {
-    char page_id[MAX_PAGE_ID_LEN];
-    struct PresenceNode* next;
-} PresenceNode;
+// arena: blocos grandes cortados sob demanda e liberados de uma vez so
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;
+    size_t size;
+    size_t used;
+    _Alignas(16) char data[]; // mesmo alinhamento do ARENA_ALIGN (sem isso o cabecalho deixa data em +24)
+} ArenaChunk;
+
+typedef struct {
+    ArenaChunk* head;
+    size_t chunkSize;
+    size_t allocations; // qtde de pedidos atendidos
+    size_t chunks;      // qtde de mallocs de verdade
+} Arena;
+
+// pool de objetos de tamanho fixo em cima de uma arena, com lista livre
+typedef struct PoolFreeNode {
+    struct PoolFreeNode* next;
+} PoolFreeNode;
 
-extern HashNode* hashTable[HASH_TABLE_SIZE];
+typedef struct {
+    Arena* arena;
+    size_t objectSize;
+    PoolFreeNode* freeList;
+} Pool;
+
+extern Arena g_arena; // arena do simulador
+
+// tabela de paginas (id -> indice denso): a global do programa fica por tras do registerPage,
+// e cada contexto do libmemsim tem a sua
+typedef struct {
+    char key[MAX_PAGE_ID_LEN]; // id da pag completado com '\0' (compara o bloco inteiro)
+    uint32_t page;             // indice denso (PAGE_NONE = slot vazio)
+} PageSlot;
+
+typedef struct PageTable {
+    PageSlot* slots;
+    uint32_t mask;    // capacidade - 1 (capacidade eh potencia de 2)
+    HashNode** nodes; // nodos indexados pelo indice denso
+    int count;        // pags distintas registradas
+    int capacity;     // tamanho de nodes
+    Arena* arena;
+    Pool nodePool;
+    struct StatCounters* counters; // sondagens contadas aqui (NULL = nao conta; a global usa o g_counters com --stats)
+} PageTable;
+
+// heap de maximo indexado por slot, usado p escolher a vitima do otimo em O(log n)
+typedef struct {
+    int* slots;    // slots em ordem de heap
+    int* position; // posicao de cada slot dentro de slots
+    long long* key; // proximo uso da pag q ta em cada slot
+    int size;
+    long long steps; // trocas feitas nos sifts (custo da escolha de vitimas, p o --stats)
+} MaxHeap;
+
+extern HashNode** g_pageNodes; // nodos indexados pelo indice denso da pagina
 
 unsigned int hashOptimize(const char* key);
 void hashInit(); //inicializa a tabela hash
-void registerPage(const char* page_id); //registrar uma pagina na lista de paginas conhecidas (tabela hash)
+uint32_t registerPage(const char* page_id); //registra a pagina (se nova) e retorna seu indice denso
+
+void pageTableInit(PageTable* table, Arena* arena);
+uint32_t pageTableIntern(PageTable* table, const char* page_id); // registra (se nova) e retorna o indice denso
+uint32_t pageTableFind(const PageTable* table, const char* page_id); // PAGE_NONE = nao registrada
+const char* pageTableName(const PageTable* table, uint32_t page);
+void pageTableFree(PageTable* table);
 
 HashNode* findNode(const char* page_id);
-void preprocessOptimal(PageAccess* accessSequence, int numAccesses);
+HashNode* pageNode(uint32_t page); // nodo a partir do indice denso
+const char* pageName(uint32_t page); // id original da pagina, so p relatorios
+int* preprocessOptimal(PageAccess* accessSequence, int numAccesses); // retorna nextUse[i] (INT_MAX = nunca mais usada)
+int* computeNextUse(const PageAccess* accessSequence, int numAccesses, int numPages); // idem, sem logs, p qq sequencia
 
-void incrementLoadCount(const char* page_id, const char* algorithm); // conta quantas veze cada pagina foi carregada na memoria (compara o desempenho dos alga)
-void loadSummary(); //printa tabela de carregamento
+void loadSummary(const char** names, int** loads, int numColumns); //printa tabela de carregamento (uma coluna por politica)
 void cleanHashTable(); //libera a memoria da tabela hash (evita vazamentos de memória)
 
-void displayFrameState(const char* algo, int num_pages, char** frames, const char* page_id, const char* pageToReplace, int slotIndex); //exibe o estado atual dos frames na memória
+void displayFrameState(const char* algo, int num_pages, const uint32_t* frames, uint32_t page, uint32_t pageToReplace, int slotIndex); //exibe o estado atual dos frames na memória
+int loadTrace(const char* filename, Trace* trace, int keepPids); // carrega o arquivo de acessos (mmap quando da)
+int loadTraceInto(const char* filename, Trace* trace, int keepPids, PageTable* pages, const TraceParser* parser); // idem, com tabela e parser proprios
+void freeTrace(Trace* trace);
+int writeBinaryTrace(const char* filename, const Trace* trace, int compact); // converte p o formato binario
+void traceParserInit(TraceParser* parser, int format, int pageShift);
+size_t parseTraceLine(TraceParser* parser, const char* line, const char* end, char* out, int* pid); // extrai o id da pag de uma linha
+int traceReaderOpen(TraceReader* reader, const char* filename, double sampleRate); // "-" = stdin; taxa 1 = tudo; 0 = ok
+int traceReaderNext(TraceReader* reader, PageAccess* out, int maxAccesses); // qtde lida (0 = fim, -1 = erro)
+void traceReaderClose(TraceReader* reader);
+
 long long parseMemorySize(const char * sizeStr); //funçao aux que converte a string de tamanho de mem para bytes
-int runOptimalSimulation(PageAccess * accessSequence, int numAccesses, int numPhysicalPages);
+int parseFrameList(const char* list, int** frameCounts); // lista "8KB,16KB" -> qtde de frames ordenada
+void arenaInit(Arena* arena, size_t chunkSize);
+void* arenaAlloc(Arena* arena, size_t size);
+void arenaRelease(Arena* arena);
+void poolInit(Pool* pool, Arena* arena, size_t objectSize);
+void* poolAlloc(Pool* pool);
+void poolFree(Pool* pool, void* ptr);
+
+void heapInit(MaxHeap* heap, int capacity);
+void heapPush(MaxHeap* heap, int slot, long long key);
+void heapUpdate(MaxHeap* heap, int slot, long long key);
+int heapTop(const MaxHeap* heap);
+void heapFree(MaxHeap* heap);
+
+// POLITICAS DE SUBSTITUIÇÃO
+// o driver (simAccess) cuida dos frames e da presença; a politica so decide quem sai
+// todas as operações sao O(1) (o otimo eh O(log frames))
+#define NEXT_USE_NEVER LLONG_MAX // pag q nao vai ser mais acessada
+#define MAX_POLICIES 16
+
+typedef struct {
+    const char* name;  // nome no --policy e nos logs
+    const char* label; // nome no relatorio
+    int needsFuture;   // precisa do proximo uso de cada acesso (offline)
+    void* (*create)(int numFrames, int numPages);
+    void (*onHit)(void* state, uint32_t page, int slot, long long nextUse); // NULL = hit nao muda nada
+    uint32_t (*chooseVictim)(void* state, uint32_t page); // so chamada com a memoria cheia; tira a vitima da politica
+    void (*onMiss)(void* state, uint32_t page, int slot, long long nextUse); // pag nova entrou no slot
+    void (*destroy)(void* state);
+    long long (*scanSteps)(void* state); // iteracoes gastas achando vitimas (NULL = sempre O(1))
+    void (*grow)(void* state, int oldPages, int numPages); // mais pags distintas (--stream); NULL = sem estado por pag
+    void (*save)(void* state, int usedFrames, int numPages, FILE* out);  // grava o estado no checkpoint
+    // le o q o save gravou e confere contra as pags residentes (slotOf da simulação ja restaurado); 0 = ok
+    int (*restore)(void* state, int usedFrames, int numPages, const int* slotOf, FILE* in);
+} ReplacementPolicy;
+
+extern const ReplacementPolicy fifoPolicy;
+extern const ReplacementPolicy optimalPolicy;
+extern const ReplacementPolicy lruPolicy;
+extern const ReplacementPolicy clockPolicy;
+extern const ReplacementPolicy lfuPolicy;
+extern const ReplacementPolicy arcPolicy;
+extern const ReplacementPolicy twoQPolicy;
+
+// uma simulação de uma politica num tamanho de memoria
+typedef struct {
+    const ReplacementPolicy* policy;
+    void* state;
+    int numFrames;
+    int usedFrames;   // slots sao ocupados em ordem
+    uint32_t* frames; // pag em cada slot
+    int* slotOf;      // slot de cada pag (-1 = fora da memoria)
+    int numPages;
+    long long faults;
+    int* loads;       // carregamentos por pag (NULL = nao conta)
+    struct HeavyHitters* hitters; // carregamentos aproximados do --top (NULL = nao conta)
+    int logSource;    // anel de logs das faltas (-1 = sem log)
+} Simulation;
+
+// lista duplamente ligada de pags; os links ficam em vetores indexados pela pag
+typedef struct {
+    uint32_t* prev;
+    uint32_t* next;
+} PageLinks;
+
+typedef struct {
+    uint32_t head; // mais recente
+    uint32_t tail; // mais antiga
+    int size;
+} PageList;
+
+const ReplacementPolicy* findPolicy(const char* name);
+int parsePolicyList(const char* list, const ReplacementPolicy** policies, int maxPolicies); // "fifo,lru" ou "all"
+void* policyAlloc(size_t count, size_t size); // calloc que aborta se faltar memoria
+void* policyRealloc(void* ptr, size_t oldCount, size_t newCount, size_t size); // realloc c/ a parte nova zerada
+void pageLinksInit(PageLinks* links, int numPages);
+void pageLinksGrow(PageLinks* links, int oldPages, int numPages);
+void pageLinksSave(const PageLinks* links, int numPages, FILE* out);
+int pageLinksRestore(PageLinks* links, int numPages, FILE* in); // -1 = truncado ou link p fora das pags
+int pageListCheck(const PageList* list, const PageLinks* links, int numPages, int maxSize, const int* slotOf, int resident,
+                  const unsigned char* where, int which); // lista lida de checkpoint: 0 = coerente
+void pageLinksFree(PageLinks* links);
+void pageListInit(PageList* list);
+void pageListPushFront(PageList* list, PageLinks* links, uint32_t page);
+void pageListRemove(PageList* list, PageLinks* links, uint32_t page);
+uint32_t pageListPopBack(PageList* list, PageLinks* links);
+
+// tempos de uma simulação (sempre medidos, custam 4 leituras de relogio por execução)
+typedef struct {
+    double wallSeconds;
+    double cpuSeconds;  // cpu da thread q rodou a simulação
+    long long scanSteps; // iteracoes escolhendo vitimas (scanSteps da politica)
+} RunStats;
+
+void simInit(Simulation* sim, const ReplacementPolicy* policy, int numFrames, int numPages, int* loads, int verbose);
+int simAccess(Simulation* sim, uint32_t page, long long index, long long nextUse); // 1 = page fault
+void simRun(Simulation* sim, const PageAccess* accessSequence, const int* nextUse, int from, int to); // acessos [from, to)
+void simGrow(Simulation* sim, int numPages); // cresce slotOf, loads e o estado da politica
+void simFree(Simulation* sim);
+long long runPolicySimulation(const ReplacementPolicy* policy, PageAccess* accessSequence, const int* nextUse, int numAccesses,
+                              int numPages, int numFrames, int* loads, struct HeavyHitters* hitters, int primary,
+                              RunStats* stats); // hitters e stats podem ser NULL
+
+// execucao paralela: cada job eh uma politica num tamanho de memoria, com estado privado
+typedef struct {
+    const ReplacementPolicy* policy;
+    int numFrames;
+    int primary; // config principal: faz logs e tem carregamentos por pag
+    int* loads;  // carregamentos por pag desse job (NULL = nao conta)
+    struct HeavyHitters* hitters; // no --top aproximado, em vez de loads
+    long long faults;
+    RunStats stats;
+    // sequencia propria do job (--multiprog); NULL = a sequencia compartilhada do runJobs
+    PageAccess* sequence;
+    const int* nextUse;
+    int numAccesses;
+    int numPages;
+} SimJob;
+
+int defaultThreadCount();
+void parallelFor(int count, int numThreads, void (*task)(void* context, int index), void* context);
+void runJobs(SimJob* jobs, int numJobs, PageAccess* accessSequence, const int* nextUse, int numAccesses, int numThreads);
+// relatorio parcial a cada reportEvery acessos, ou a cada reportSeconds qdo reportEvery = 0; retorna os acessos (-1 = erro)
+long long runStreamJobs(const char* filename, SimJob* jobs, int numJobs, long long reportEvery, double reportSeconds);
+
+// CHECKPOINT (--checkpoint, --resume)
+void checkpointWrite(FILE* out, const void* data, size_t size); // erros ficam no ferror(out)
+int checkpointRead(FILE* in, void* data, size_t size);          // 0 = leu tudo
+int checkpointPageOk(uint32_t page, int numPages);               // pag lida do arquivo eh indice valido (ou PAGE_NONE)
+int* loadCheckpointNextUse(const char* path, int numAccesses);  // nextUse salvo junto do checkpoint (NULL = nao tem)
+int runCheckpointedJobs(SimJob* jobs, int numJobs, PageAccess* accessSequence, const int* nextUse, int numAccesses,
+                        int numThreads, const char* checkpointPath, const char* resumePath, int interval); // 0 = ok
+int runMultiprogramming(const Trace* trace, const ReplacementPolicy** policies, int numPolicies, int numFrames,
+                        int proportional, int numThreads); // particoes locais por pid x pool global (0 = ok)
+
+// TAMANHO DE PAGINA (--page-size, --huge)
+int pageSizeShift(long long pageSize); // log2(pageSize / 4KB); -1 = tamanho invalido
+int splitPageId(const char* id, size_t* prefixLen, uint64_t* number); // "D2513" -> "D" + 2513; 0 = sem numero
+void applyPageSize(Trace* trace, int shift); // junta 2^shift pags do trace em uma (refaz a tabela hash)
+int runHugePages(Trace* trace, const ReplacementPolicy** policies, int numPolicies, long long memBytes,
+                 long long hugeSize, double hugeShare, int numThreads); // pool base + pool de pags enormes (0 = ok)
+
+// WORKING SET E PFF (--ws): W(t, tau) e a politica page fault frequency numa passada, serie temporal em csv
+int runWorkingSetAnalysis(const PageAccess* accessSequence, int numAccesses, const int* taus, int numTaus, int numFrames,
+                          int points, const char* outPath); // 0 = ok
+
+// POOLS I/D (--split): instruções e dados em pools separados, divisao fixa ou adaptativa x pool unico
+int runSplitPools(const Trace* trace, const ReplacementPolicy** policies, int numPolicies, int numFrames, double iShare,
+                  int adaptive, int numThreads); // 0 = ok
+
+// TRADUÇÃO (--tlb): TLB associativa por conjunto + page walk numa tabela de varios niveis
+#define MAX_PAGE_TABLE_LEVELS 4
+enum { TLB_LRU, TLB_FIFO, TLB_RANDOM };
+
+typedef struct {
+    int entries;
+    int ways;        // entries = totalmente associativa
+    int replacement; // TLB_LRU, TLB_FIFO ou TLB_RANDOM
+    int levels;      // niveis da tabela de paginas (2 a 4)
+} TlbConfig;
+
+typedef struct {
+    long long accesses;
+    long long hits;
+    long long walks;
+    long long walkReferences;                // acessos a memoria nos page walks
+    long long nodes[MAX_PAGE_TABLE_LEVELS];  // nos da tabela em cada nivel (raiz = 0)
+    long long tableBytes;                    // memoria ocupada pela tabela de varios niveis
+} TlbResult;
+
+int parseTlbConfig(const char* text, TlbConfig* config); // "64", "64x4" ou "64x4,fifo"; 0 = ok
+void runTlbSimulation(const PageAccess* accessSequence, int numAccesses, const TlbConfig* config, TlbResult* result);
+void printTlbReport(const TlbConfig* config, const TlbResult* result);
+
+// PAGS MAIS RECARREGADAS (--top): space-saving p as candidatas + count-min p estimar qq pag, memoria fixa
+#define HEAVY_HITTER_COUNTERS 4096 // contadores do space-saving por politica (padrao do --top=K,aprox)
+
+typedef struct HeavyHitters {
+    int capacity;
+    int size;
+    uint32_t* pages;      // heap de minimo pela contagem
+    long long* counts;
+    long long* errors;    // qto a contagem pode passar da real
+    uint32_t* slotOfPos;  // slot do indice de cada posicao do heap
+    uint32_t* indexKeys;  // indice pag -> posicao (PAGE_NONE = vazio)
+    int* indexPos;
+    uint32_t indexMask;
+    long long* cm;        // count-min, CM_DEPTH linhas de cmWidth
+    uint32_t cmWidth;
+    long long total;      // cargas contadas
+} HeavyHitters;
+
+HeavyHitters* heavyHittersCreate(int counters);
+void heavyHittersAdd(HeavyHitters* hitters, uint32_t page);
+long long heavyHittersQuery(const HeavyHitters* hitters, uint32_t page); // estimativa do count-min (>= real)
+size_t heavyHittersBytes(const HeavyHitters* hitters);
+void heavyHittersFree(HeavyHitters* hitters);
+int runTopReport(const char** names, int** loads, HeavyHitters** hitters, int numColumns, int optimalColumn, int k,
+                 int numPages, const char* outPath); // loads NULL = aproximado; csv ou json (.json); 0 = ok
+
+// LOGS DE FALTAS (-v, modo didatico, --log): registros binarios num anel por simulação, formatados numa thread de fundo
+int eventLogStart(const char* binaryPath); // NULL = texto no stdout; senao grava o log binario (0 = ok)
+int eventLogActive();
+int eventLogSource(const char* name, int numFrames); // anel de uma simulação (-1 = logs desligados)
+void eventLogFault(int source, long long index, uint32_t page, uint32_t victim, int slot);
+void eventLogFlush(); // espera o texto do q ja foi gravado sair (antes de imprimir direto no stdout)
+void eventLogStop();  // no --log fecha o arquivo com os nomes das pags
+int decodeEventLog(const char* path, int showFrames); // --decode: log binario -> texto do -v (0 = ok)
+
+// ESTATÍSTICAS (--stats): tempos por fase, sondagens da tabela de paginas e alocações
+typedef struct StatCounters {
+    long long lookups;      // buscas na tabela de paginas
+    long long probes;       // slots visitados nessas buscas
+    int maxProbe;           // maior sondagem
+    uint32_t tableCapacity; // capacidade atual da tabela
+    long long registerCalls;
+    double registerSeconds; // tempo de parede dentro do registerPage
+    long long policyAllocs; // callocs feitos pelas politicas/driver
+} StatCounters;
+
+extern StatCounters g_counters;
+
+double wallClock();      // segundos, relogio monotonico
+double cpuClock();       // cpu do processo
+double threadCpuClock(); // cpu da thread atual
+void statsProbe(StatCounters* counters, int length);
+void statsRecord(const char* name, double wallSeconds, double cpuSeconds, long long items, long long faults, long long scanSteps);
+void printStats(); // relatorio das fases registradas + contadores
+
+// CURVA APROXIMADA (SHARDS): so as pags cujo hash do id cai abaixo de taxa * 2^32 entram na amostra,
+// e as distancias de pilha medidas nela sao escaladas por 1/taxa
+typedef struct {
+    double rate;
+    int maxFrames;
+    long long accesses;  // todos os acessos vistos (amostrados ou nao)
+    long long sampled;   // acessos amostrados
+    long long* hitsAt;   // hits por distancia ja escalada (1..maxFrames)
+    int* tree;           // fenwick sobre as posicoes dos acessos amostrados (1 = ultimo acesso da pag)
+    uint32_t* pageAt;    // pag de cada posicao (PAGE_NONE = nao eh mais o ultimo acesso dela)
+    int capacity;        // posicoes; compacta qdo enche, entao cresce com as pags amostradas e nao com o trace
+    int used;
+    int* lastPos;        // ultima posicao de cada pag (-1 = nunca vista)
+    int lastCapacity;
+} ShardsSampler;
+
+uint64_t sampleThreshold(double rate);
+int pageSampled(const char* page_id, uint64_t threshold);
+void shardsInit(ShardsSampler* sampler, double rate, int maxFrames);
+void shardsAccess(ShardsSampler* sampler, uint32_t page); // acesso a uma pag da amostra
+double shardsMissRatio(const ShardsSampler* sampler, int numFrames);
+void shardsFree(ShardsSampler* sampler);
+
+void runMissRatioCurve(PageAccess* accessSequence, int numAccesses, const int* frameCounts, int numSizes, const char* outPath,
+                       double sampleRate); // curva lru/otimo/fifo em csv; taxa < 1 compara com a aproximada
+int runSampledCurve(const char* filename, const int* frameCounts, int numSizes, double sampleRate, const char* outPath); // so a aproximada, em streaming
 
 #endif
\ No newline at end of file
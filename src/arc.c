@@ -0,0 +1,158 @@
+#include "simulator.h"
+
+// ARC (Megiddo & Modha): T1 = vistas uma vez, T2 = vistas mais de uma vez,
+// B1/B2 = historico (fantasmas) das expulsas de T1/T2; p = tamanho alvo de T1, ajustado pelos acertos nos fantasmas
+// cada pag ta em no maximo uma lista, entao um vetor de links so serve p todas
+
+enum { ARC_NONE, ARC_T1, ARC_T2, ARC_B1, ARC_B2 };
+
+typedef struct {
+    PageLinks links;
+    unsigned char* where; // em qual lista cada pag ta
+    PageList t1, t2, b1, b2;
+    int capacity;         // c
+    int target;           // p
+} ArcState;
+
+static void* arcCreate(int numFrames, int numPages) {
+    ArcState* state = (ArcState*)policyAlloc(1, sizeof(ArcState));
+    pageLinksInit(&state->links, numPages);
+    state->where = (unsigned char*)policyAlloc(numPages, sizeof(unsigned char));
+    pageListInit(&state->t1);
+    pageListInit(&state->t2);
+    pageListInit(&state->b1);
+    pageListInit(&state->b2);
+    state->capacity = numFrames;
+    return state;
+}
+
+static PageList* arcList(ArcState* state, int which) {
+    switch (which) {
+        case ARC_T1: return &state->t1;
+        case ARC_T2: return &state->t2;
+        case ARC_B1: return &state->b1;
+        default: return &state->b2;
+    }
+}
+
+static void arcMove(ArcState* state, uint32_t page, int to) {
+    if (state->where[page] != ARC_NONE) pageListRemove(arcList(state, state->where[page]), &state->links, page);
+    state->where[page] = to;
+    if (to != ARC_NONE) pageListPushFront(arcList(state, to), &state->links, page);
+}
+
+// tira o lru do fantasma q passou do limite
+static void arcDropGhost(ArcState* state, PageList* ghost) {
+    uint32_t page = pageListPopBack(ghost, &state->links);
+    if (page != PAGE_NONE) state->where[page] = ARC_NONE;
+}
+
+// REPLACE(x, p): expulsa o lru de T1 ou de T2 conforme o alvo p e manda p o fantasma correspondente
+static uint32_t arcReplace(ArcState* state, int incomingInB2) {
+    int fromT1 = state->t1.size > 0 &&
+                 ((incomingInB2 && state->t1.size == state->target) || state->t1.size > state->target);
+    if (state->t2.size == 0) fromT1 = 1;
+
+    uint32_t victim = fromT1 ? state->t1.tail : state->t2.tail;
+    arcMove(state, victim, fromT1 ? ARC_B1 : ARC_B2);
+    return victim;
+}
+
+static void arcOnHit(void* raw, uint32_t page, int slot, long long nextUse) {
+    arcMove((ArcState*)raw, page, ARC_T2);
+}
+
+static uint32_t arcChooseVictim(void* raw, uint32_t page) {
+    ArcState* state = (ArcState*)raw;
+    int c = state->capacity;
+
+    if (state->where[page] == ARC_B1) {
+        int delta = (state->b2.size > state->b1.size) ? state->b2.size / state->b1.size : 1;
+        state->target = (state->target + delta < c) ? state->target + delta : c;
+        return arcReplace(state, 0);
+    }
+    if (state->where[page] == ARC_B2) {
+        int delta = (state->b1.size > state->b2.size) ? state->b1.size / state->b2.size : 1;
+        state->target = (state->target - delta > 0) ? state->target - delta : 0;
+        return arcReplace(state, 1);
+    }
+
+    // pag fora de todas as listas
+    if (state->t1.size + state->b1.size == c) {
+        if (state->t1.size < c) {
+            arcDropGhost(state, &state->b1);
+            return arcReplace(state, 0);
+        }
+        // B1 vazio: expulsa o lru de T1 sem guardar historico
+        uint32_t victim = state->t1.tail;
+        arcMove(state, victim, ARC_NONE);
+        return victim;
+    }
+    if (state->t1.size + state->t2.size + state->b1.size + state->b2.size >= 2 * c) {
+        arcDropGhost(state, &state->b2);
+    }
+    return arcReplace(state, 0);
+}
+
+// acerto em fantasma vai p T2, pag nova vai p T1
+static void arcOnMiss(void* raw, uint32_t page, int slot, long long nextUse) {
+    ArcState* state = (ArcState*)raw;
+    int ghost = state->where[page] == ARC_B1 || state->where[page] == ARC_B2;
+    arcMove(state, page, ghost ? ARC_T2 : ARC_T1);
+}
+
+static void arcDestroy(void* raw) {
+    ArcState* state = (ArcState*)raw;
+    pageLinksFree(&state->links);
+    free(state->where);
+    free(state);
+}
+
+static void arcGrow(void* raw, int oldPages, int numPages) {
+    ArcState* state = (ArcState*)raw;
+    pageLinksGrow(&state->links, oldPages, numPages);
+    state->where = (unsigned char*)policyRealloc(state->where, oldPages, numPages, sizeof(unsigned char));
+}
+
+static void arcSave(void* raw, int usedFrames, int numPages, FILE* out) {
+    ArcState* state = (ArcState*)raw;
+    PageList lists[4] = { state->t1, state->t2, state->b1, state->b2 };
+    checkpointWrite(out, lists, sizeof(lists));
+    checkpointWrite(out, &state->target, sizeof(int));
+    checkpointWrite(out, state->where, numPages);
+    pageLinksSave(&state->links, numPages, out);
+}
+
+static int arcRestore(void* raw, int usedFrames, int numPages, const int* slotOf, FILE* in) {
+    ArcState* state = (ArcState*)raw;
+    PageList lists[4];
+    if (checkpointRead(in, lists, sizeof(lists)) != 0 || checkpointRead(in, &state->target, sizeof(int)) != 0) return -1;
+    state->t1 = lists[0];
+    state->t2 = lists[1];
+    state->b1 = lists[2];
+    state->b2 = lists[3];
+    if (checkpointRead(in, state->where, numPages) != 0) return -1;
+    if (pageLinksRestore(&state->links, numPages, in) != 0) return -1;
+
+    // T1 e T2 tem exatamente as residentes; B1 e B2 so historico. o where de cada pag bate com a lista dela
+    int inList[ARC_B2 + 1] = { 0 };
+    for (int p = 0; p < numPages; p++) {
+        if (state->where[p] > ARC_B2) return -1;
+        inList[state->where[p]]++;
+    }
+    for (int which = ARC_T1; which <= ARC_B2; which++) {
+        const PageList* list = arcList(state, which);
+        int resident = (which == ARC_T1 || which == ARC_T2);
+        if (list->size != inList[which] ||
+            pageListCheck(list, &state->links, numPages, numPages, slotOf, resident, state->where, which) != 0) {
+            return -1;
+        }
+    }
+    if (state->t1.size + state->t2.size != usedFrames || state->target < 0 || state->target > state->capacity) return -1;
+    return 0;
+}
+
+const ReplacementPolicy arcPolicy = {
+    "arc", "ARC", 0, arcCreate, arcOnHit, arcChooseVictim, arcOnMiss, arcDestroy, NULL, arcGrow,
+    arcSave, arcRestore
+};
@@ -0,0 +1,76 @@
+#include "simulator.h"
+#include <stddef.h>
+
+// alocacao em arena: blocos grandes cortados em pedaços, liberados todos de uma vez
+// pool: objetos de tamanho fixo tirados da arena, com lista livre p reaproveitar os devolvidos
+
+#define ARENA_ALIGN 16 // tem q bater com o _Alignas do data[] no ArenaChunk
+_Static_assert(offsetof(ArenaChunk, data) % ARENA_ALIGN == 0, "data[] do ArenaChunk desalinhado");
+
+Arena g_arena; // arena do simulador (nodos da tabela de paginas)
+
+void arenaInit(Arena* arena, size_t chunkSize) {
+    arena->head = NULL;
+    arena->chunkSize = chunkSize;
+    arena->allocations = 0;
+    arena->chunks = 0;
+}
+
+void* arenaAlloc(Arena* arena, size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    ArenaChunk* chunk = arena->head;
+
+    if (!chunk || chunk->used + size > chunk->size) {
+        size_t chunkSize = (size > arena->chunkSize) ? size : arena->chunkSize;
+        chunk = (ArenaChunk*)malloc(sizeof(ArenaChunk) + chunkSize);
+        if (!chunk) {
+            perror("falha ao alocar bloco da arena");
+            exit(1);
+        }
+        chunk->size = chunkSize;
+        chunk->used = 0;
+        chunk->next = arena->head;
+        arena->head = chunk;
+        arena->chunks++;
+    }
+
+    void* ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->allocations++;
+    return ptr;
+}
+
+// libera todos os blocos de uma vez (tudo q saiu da arena deixa de valer)
+void arenaRelease(Arena* arena) {
+    ArenaChunk* chunk = arena->head;
+    while (chunk) {
+        ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->head = NULL;
+    arena->allocations = 0;
+    arena->chunks = 0;
+}
+
+void poolInit(Pool* pool, Arena* arena, size_t objectSize) {
+    pool->arena = arena;
+    pool->objectSize = (objectSize < sizeof(PoolFreeNode)) ? sizeof(PoolFreeNode) : objectSize;
+    pool->freeList = NULL;
+}
+
+void* poolAlloc(Pool* pool) {
+    if (pool->freeList) {
+        PoolFreeNode* node = pool->freeList;
+        pool->freeList = node->next;
+        return node;
+    }
+    return arenaAlloc(pool->arena, pool->objectSize);
+}
+
+// devolve o objeto p lista livre; a memoria so volta pro sistema no arenaRelease
+void poolFree(Pool* pool, void* ptr) {
+    PoolFreeNode* node = (PoolFreeNode*)ptr;
+    node->next = pool->freeList;
+    pool->freeList = node;
+}
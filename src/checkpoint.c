@@ -0,0 +1,296 @@
+#include "simulator.h"
+#include <errno.h>
+#include <unistd.h>
+
+// checkpoint (--checkpoint / --resume): as simulações andam juntas em blocos de acessos e, entre um
+// bloco e outro, o estado inteiro de todos os jobs vai p um arquivo binario
+// (frames, presença, carregamentos, estado de cada politica e o indice do proximo acesso)
+// o arquivo eh gravado num .tmp e renomeado, entao o ultimo checkpoint bom nunca fica pela metade
+// o nextUse do otimo vai uma vez so p <arq>.next, e o --resume le ele em vez de refazer o pre processamento
+
+#define CHECKPOINT_MAGIC "MEMSIMCK"
+#define NEXT_USE_MAGIC "MEMSIMNU"
+#define CHECKPOINT_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    int32_t numJobs;
+    int64_t numAccesses;
+    int32_t numPages;
+    int32_t pageShift; // log2(tam da pag / 4KB): outro --page-size daria outras pags
+    int64_t position;  // proximo acesso a simular
+} CheckpointHeader;
+
+typedef struct {
+    char policy[16];
+    int32_t numFrames;
+    int32_t usedFrames;
+    int64_t faults;
+    int32_t hasLoads;
+    int32_t reserved;
+    double wallSeconds;
+    double cpuSeconds;
+} CheckpointJob;
+
+// erros de escrita ficam no FILE (ferror) e sao checados uma vez no fim
+void checkpointWrite(FILE* out, const void* data, size_t size) {
+    if (size > 0) fwrite(data, 1, size, out);
+}
+
+int checkpointRead(FILE* in, void* data, size_t size) {
+    if (size == 0) return 0;
+    return (fread(data, 1, size, in) == size) ? 0 : -1;
+}
+
+// tudo q o checkpoint traz e vira indice (pags, slots) eh conferido antes de usar: um arquivo corrompido
+// ou de outra execução q passe pelo cabeçalho nao pode escrever fora dos vetores
+int checkpointPageOk(uint32_t page, int numPages) {
+    return page == PAGE_NONE || page < (uint32_t)numPages;
+}
+
+// frames e slotOf coerentes: slots usados com pag valida apontando de volta, o resto vazio
+static int framesOk(const Simulation* sim) {
+    for (int s = 0; s < sim->numFrames; s++) {
+        uint32_t page = sim->frames[s];
+        if (s >= sim->usedFrames) {
+            if (page != PAGE_NONE) return 0;
+        } else if (page >= (uint32_t)sim->numPages || sim->slotOf[page] != s) {
+            return 0;
+        }
+    }
+    for (int p = 0; p < sim->numPages; p++) {
+        int slot = sim->slotOf[p];
+        if (slot != -1 && (slot < 0 || slot >= sim->usedFrames || sim->frames[slot] != (uint32_t)p)) return 0;
+    }
+    return 1;
+}
+
+// cada carregamento eh uma falta: nenhuma pag passa do total de faltas
+static int loadsOk(const Simulation* sim) {
+    for (int p = 0; p < sim->numPages; p++) {
+        if (sim->loads[p] < 0 || sim->loads[p] > sim->faults) return 0;
+    }
+    return 1;
+}
+
+static void nextUsePath(char* out, size_t size, const char* path) {
+    snprintf(out, size, "%s.next", path);
+}
+
+static int saveNextUse(const char* path, const int* nextUse, int numAccesses) {
+    char name[4096];
+    nextUsePath(name, sizeof(name), path);
+    FILE* out = fopen(name, "wb");
+    if (!out) return -1;
+    int64_t count = numAccesses;
+    checkpointWrite(out, NEXT_USE_MAGIC, 8);
+    checkpointWrite(out, &count, sizeof(count));
+    checkpointWrite(out, nextUse, (size_t)numAccesses * sizeof(int));
+    int failed = ferror(out);
+    return (fclose(out) != 0 || failed) ? -1 : 0;
+}
+
+// le o nextUse gravado junto do checkpoint; NULL = nao tem (ou eh de outro trace)
+int* loadCheckpointNextUse(const char* path, int numAccesses) {
+    char name[4096];
+    nextUsePath(name, sizeof(name), path);
+    FILE* in = fopen(name, "rb");
+    if (!in) return NULL;
+
+    char magic[8];
+    int64_t count;
+    int* nextUse = NULL;
+    if (checkpointRead(in, magic, 8) == 0 && memcmp(magic, NEXT_USE_MAGIC, 8) == 0 &&
+        checkpointRead(in, &count, sizeof(count)) == 0 && count == numAccesses) {
+        nextUse = (int*)malloc((numAccesses > 0 ? numAccesses : 1) * sizeof(int));
+        if (!nextUse) {
+            perror("falha ao alocar memoria para usos futuros");
+            exit(1);
+        }
+        if (checkpointRead(in, nextUse, (size_t)numAccesses * sizeof(int)) != 0) {
+            free(nextUse);
+            nextUse = NULL;
+        }
+    }
+    fclose(in);
+    return nextUse;
+}
+
+static int saveCheckpoint(const char* path, Simulation* sims, SimJob* jobs, int numJobs, int numAccesses, int position) {
+    char temp[4096];
+    snprintf(temp, sizeof(temp), "%s.tmp", path);
+    FILE* out = fopen(temp, "wb");
+    if (!out) return -1;
+
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, 8);
+    header.version = CHECKPOINT_VERSION;
+    header.numJobs = numJobs;
+    header.numAccesses = numAccesses;
+    header.numPages = g_pageCount;
+    header.pageShift = pageSizeShift(g_pageSize);
+    header.position = position;
+    checkpointWrite(out, &header, sizeof(header));
+
+    for (int j = 0; j < numJobs; j++) {
+        Simulation* sim = &sims[j];
+        CheckpointJob job;
+        memset(&job, 0, sizeof(job));
+        snprintf(job.policy, sizeof(job.policy), "%s", sim->policy->name);
+        job.numFrames = sim->numFrames;
+        job.usedFrames = sim->usedFrames;
+        job.faults = sim->faults;
+        job.hasLoads = (sim->loads != NULL);
+        job.wallSeconds = jobs[j].stats.wallSeconds;
+        job.cpuSeconds = jobs[j].stats.cpuSeconds;
+        checkpointWrite(out, &job, sizeof(job));
+        checkpointWrite(out, sim->frames, sim->numFrames * sizeof(uint32_t));
+        checkpointWrite(out, sim->slotOf, sim->numPages * sizeof(int));
+        if (sim->loads) checkpointWrite(out, sim->loads, sim->numPages * sizeof(int));
+        sim->policy->save(sim->state, sim->usedFrames, sim->numPages, out);
+    }
+
+    // so troca o checkpoint anterior depois q o novo ta inteiro no disco
+    int failed = (fflush(out) != 0 || ferror(out) || fsync(fileno(out)) != 0);
+    if (fclose(out) != 0) failed = 1;
+    if (failed || rename(temp, path) != 0) {
+        int error = errno;
+        unlink(temp);
+        errno = error;
+        return -1;
+    }
+    return 0;
+}
+
+// retorna o proximo acesso a simular (-1 = checkpoint invalido ou de outra configuração)
+static int restoreCheckpoint(const char* path, Simulation* sims, SimJob* jobs, int numJobs, int numAccesses) {
+    FILE* in = fopen(path, "rb");
+    if (!in) {
+        perror("[ERRO] ao abrir o checkpoint");
+        return -1;
+    }
+
+    CheckpointHeader header;
+    const char* problem = NULL;
+    if (checkpointRead(in, &header, sizeof(header)) != 0 || memcmp(header.magic, CHECKPOINT_MAGIC, 8) != 0 ||
+        header.version != CHECKPOINT_VERSION) {
+        problem = "arquivo não é um checkpoint desta versão";
+    } else if (header.numAccesses != numAccesses || header.numPages != g_pageCount || header.pageShift != pageSizeShift(g_pageSize)) {
+        problem = "checkpoint de outro trace ou outro tamanho de página";
+    } else if (header.numJobs != numJobs || header.position < 0 || header.position > numAccesses) {
+        problem = "checkpoint com outras políticas ou tamanhos (use as mesmas opções da execução original)";
+    }
+
+    for (int j = 0; !problem && j < numJobs; j++) {
+        Simulation* sim = &sims[j];
+        CheckpointJob job;
+        if (checkpointRead(in, &job, sizeof(job)) != 0) {
+            problem = "checkpoint truncado";
+            break;
+        }
+        job.policy[sizeof(job.policy) - 1] = '\0';
+        if (strcmp(job.policy, sim->policy->name) != 0 || job.numFrames != sim->numFrames || job.hasLoads != (sim->loads != NULL) ||
+            job.usedFrames < 0 || job.usedFrames > sim->numFrames) {
+            problem = "checkpoint com outras políticas ou tamanhos (use as mesmas opções da execução original)";
+            break;
+        }
+        if (job.faults < job.usedFrames || job.faults > header.position) {
+            problem = "checkpoint truncado ou corrompido";
+            break;
+        }
+        sim->usedFrames = job.usedFrames;
+        sim->faults = job.faults;
+        jobs[j].stats.wallSeconds = job.wallSeconds;
+        jobs[j].stats.cpuSeconds = job.cpuSeconds;
+        if (checkpointRead(in, sim->frames, sim->numFrames * sizeof(uint32_t)) != 0 ||
+            checkpointRead(in, sim->slotOf, sim->numPages * sizeof(int)) != 0 ||
+            (sim->loads && checkpointRead(in, sim->loads, sim->numPages * sizeof(int)) != 0) || !framesOk(sim) ||
+            (sim->loads && !loadsOk(sim)) ||
+            sim->policy->restore(sim->state, sim->usedFrames, sim->numPages, sim->slotOf, in) != 0) {
+            problem = "checkpoint truncado ou corrompido";
+        }
+    }
+    fclose(in);
+
+    if (problem) {
+        fprintf(stderr, "[ERRO] %s: %s.\n", path, problem);
+        return -1;
+    }
+    return (int)header.position;
+}
+
+typedef struct {
+    Simulation* sims;
+    SimJob* jobs;
+    const PageAccess* accessSequence;
+    const int* nextUse;
+    int from;
+    int to;
+} CheckpointBlock;
+
+static void runBlock(void* context, int index) {
+    CheckpointBlock* block = (CheckpointBlock*)context;
+    Simulation* sim = &block->sims[index];
+    double wallStart = wallClock();
+    double cpuStart = threadCpuClock();
+    simRun(sim, block->accessSequence, sim->policy->needsFuture ? block->nextUse : NULL, block->from, block->to);
+    block->jobs[index].stats.wallSeconds += wallClock() - wallStart;
+    block->jobs[index].stats.cpuSeconds += threadCpuClock() - cpuStart;
+    eventLogFlush(); // logs de um job antes dos do proximo (e antes da linha do checkpoint)
+}
+
+// como o runJobs, mas todos os jobs andam juntos e o estado vai p checkpointPath a cada interval acessos
+// resumePath (opcional) eh o checkpoint de onde continuar; 0 = ok
+int runCheckpointedJobs(SimJob* jobs, int numJobs, PageAccess* accessSequence, const int* nextUse, int numAccesses,
+                        int numThreads, const char* checkpointPath, const char* resumePath, int interval) {
+    Simulation* sims = (Simulation*)policyAlloc(numJobs, sizeof(Simulation));
+    for (int j = 0; j < numJobs; j++) {
+        simInit(&sims[j], jobs[j].policy, jobs[j].numFrames, g_pageCount, jobs[j].loads, jobs[j].primary && g_verbose);
+    }
+
+    int position = 0;
+    if (resumePath) {
+        position = restoreCheckpoint(resumePath, sims, jobs, numJobs, numAccesses);
+        if (position < 0) {
+            for (int j = 0; j < numJobs; j++) simFree(&sims[j]);
+            free(sims);
+            return -1;
+        }
+        printf("\ncontinuando do checkpoint %s no acesso %d de %d.\n", resumePath, position, numAccesses);
+    }
+
+    // o nextUse so precisa ir pro disco se ainda nao ta do lado do checkpoint
+    if (nextUse && !(resumePath && strcmp(resumePath, checkpointPath) == 0)) {
+        if (saveNextUse(checkpointPath, nextUse, numAccesses) != 0) perror("[aviso] falha ao gravar o nextUse do checkpoint");
+    }
+
+    printf("\nexecutando em blocos de %d acessos, com checkpoint em %s...\n", interval, checkpointPath);
+    CheckpointBlock block = { sims, jobs, accessSequence, nextUse, position, position };
+    double start = wallClock();
+    while (block.from < numAccesses) {
+        block.to = (numAccesses - block.from > interval) ? block.from + interval : numAccesses;
+        parallelFor(numJobs, numThreads, runBlock, &block);
+        block.from = block.to;
+        if (block.from >= numAccesses) break;
+
+        // um checkpoint com falha nao para a simulação: o anterior continua valendo
+        double saveStart = wallClock();
+        if (saveCheckpoint(checkpointPath, sims, jobs, numJobs, numAccesses, block.from) != 0) {
+            perror("[aviso] falha ao gravar o checkpoint");
+        } else {
+            printf("[checkpoint] acesso %d de %d (%.1f%%) gravado em %.2fs; %.0f acessos/s.\n", block.from, numAccesses,
+                   100.0 * block.from / numAccesses, wallClock() - saveStart, (block.from - position) / (wallClock() - start));
+        }
+    }
+
+    for (int j = 0; j < numJobs; j++) {
+        Simulation* sim = &sims[j];
+        jobs[j].faults = sim->faults;
+        jobs[j].stats.scanSteps = sim->policy->scanSteps ? sim->policy->scanSteps(sim->state) : 0;
+        simFree(sim);
+    }
+    free(sims);
+    return 0;
+}
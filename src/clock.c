@@ -0,0 +1,80 @@
+#include "simulator.h"
+
+// CLOCK (segunda chance): ponteiro circular sobre os slots com bit de referencia
+// o hit so liga o bit; na falta o ponteiro zera bits ate achar um slot com bit 0 (O(1) amortizado)
+
+typedef struct {
+    uint32_t* pageAt;         // pag em cada slot
+    unsigned char* reference; // bit de referencia de cada slot
+    int numFrames;
+    int hand;
+    long long steps; // slots que o ponteiro pulou dando segunda chance
+} ClockState;
+
+static void* clockCreate(int numFrames, int numPages) {
+    ClockState* state = (ClockState*)policyAlloc(1, sizeof(ClockState));
+    state->pageAt = (uint32_t*)policyAlloc(numFrames, sizeof(uint32_t));
+    state->reference = (unsigned char*)policyAlloc(numFrames, sizeof(unsigned char));
+    state->numFrames = numFrames;
+    return state;
+}
+
+static void clockOnHit(void* raw, uint32_t page, int slot, long long nextUse) {
+    ClockState* state = (ClockState*)raw;
+    state->reference[slot] = 1;
+}
+
+static uint32_t clockChooseVictim(void* raw, uint32_t page) {
+    ClockState* state = (ClockState*)raw;
+    while (state->reference[state->hand]) {
+        state->reference[state->hand] = 0; // segunda chance
+        state->hand = (state->hand + 1) % state->numFrames;
+        state->steps++;
+    }
+    return state->pageAt[state->hand];
+}
+
+// a pag nova entra com bit 1 (o carregamento conta como referencia, como no CLOCK classico) e o ponteiro
+// passa p o proximo slot; com bit 0 ela sairia antes do 1o reuso poder proteger
+static void clockOnMiss(void* raw, uint32_t page, int slot, long long nextUse) {
+    ClockState* state = (ClockState*)raw;
+    state->pageAt[slot] = page;
+    state->reference[slot] = 1;
+    if (slot == state->hand) state->hand = (state->hand + 1) % state->numFrames;
+}
+
+static void clockDestroy(void* raw) {
+    ClockState* state = (ClockState*)raw;
+    free(state->pageAt);
+    free(state->reference);
+    free(state);
+}
+
+static long long clockScanSteps(void* raw) {
+    ClockState* state = (ClockState*)raw;
+    return state->steps;
+}
+
+static void clockSave(void* raw, int usedFrames, int numPages, FILE* out) {
+    ClockState* state = (ClockState*)raw;
+    checkpointWrite(out, &state->hand, sizeof(int));
+    checkpointWrite(out, &state->steps, sizeof(long long));
+    checkpointWrite(out, state->pageAt, state->numFrames * sizeof(uint32_t));
+    checkpointWrite(out, state->reference, state->numFrames);
+}
+
+static int clockRestore(void* raw, int usedFrames, int numPages, const int* slotOf, FILE* in) {
+    ClockState* state = (ClockState*)raw;
+    if (checkpointRead(in, &state->hand, sizeof(int)) != 0 || state->hand < 0 || state->hand >= state->numFrames) return -1;
+    if (checkpointRead(in, &state->steps, sizeof(long long)) != 0) return -1;
+    if (checkpointRead(in, state->pageAt, state->numFrames * sizeof(uint32_t)) != 0) return -1;
+    for (int s = 0; s < usedFrames; s++) {
+        if (state->pageAt[s] >= (uint32_t)numPages || slotOf[state->pageAt[s]] != s) return -1;
+    }
+    return checkpointRead(in, state->reference, state->numFrames);
+}
+
+const ReplacementPolicy clockPolicy = {
+    "clock", "CLOCK", 0, clockCreate, clockOnHit, clockChooseVictim, clockOnMiss, clockDestroy, clockScanSteps, NULL,
+    clockSave, clockRestore
+};
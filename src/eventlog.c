@@ -0,0 +1,298 @@
+#include "simulator.h"
+#include <pthread.h>
+#include <unistd.h>
+
+// logs de falta (-v, modo didatico e --log): a simulação so grava um registro binario de tamanho fixo
+// (acesso, pag, vitima, slot) num anel sem trava; uma thread de fundo esvazia os aneis e formata o texto
+// (ou grava o binario do --log, q o --decode transforma em texto depois)
+//
+// um anel por simulação (um produtor so por anel), entao nao precisa de atomico no produtor alem do tail
+// no modo didatico a thread de fundo refaz os frames de cada simulação a partir dos proprios eventos
+
+#define LOG_RING_SIZE (1 << 16) // eventos por anel (potencia de 2)
+#define MAX_LOG_SOURCES 64
+#define LOG_MAGIC "MEMSIMLG"
+#define LOG_VERSION 1
+
+typedef struct {
+    int64_t index;   // posicao do acesso na sequencia
+    uint32_t page;
+    uint32_t victim; // PAGE_NONE = entrou num slot vazio
+    int32_t slot;
+    uint16_t source; // simulação q gerou (indice em sources)
+    uint16_t reserved;
+} LogEvent;
+
+typedef struct {
+    // head e tail em linhas de cache separadas: produtor e consumidor nao disputam a mesma linha
+    uint32_t tail;
+    char padTail[60];
+    uint32_t head;
+    char padHead[60];
+    LogEvent* events;
+    char name[16];
+    int numFrames;
+    uint32_t* frames;   // frames refeitos pela thread de fundo (so no modo didatico)
+    long long faults;   // faltas ja formatadas
+} LogRing;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t eventSize;
+} LogHeader;
+
+// fim do arquivo: tabela de simulações e dicionario de pags ficam depois dos eventos
+typedef struct {
+    uint64_t footerOffset;
+    uint32_t numSources;
+    uint32_t numPages;
+    char magic[8];
+} LogTrailer;
+
+static LogRing* sources[MAX_LOG_SOURCES];
+static int numSources = 0;
+static pthread_mutex_t sourcesLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t drainThread;
+static int running = 0;
+static int stopping = 0;
+static FILE* binaryOut = NULL; // NULL = texto no stdout
+
+static void formatEvent(LogRing* ring, const LogEvent* event) {
+    ring->faults++;
+    const char* oldPage = (event->victim != PAGE_NONE) ? pageName(event->victim) : "empty";
+    printf("[%s] page fault #%lld (acesso #%lld): página '%s' não encontrada, substituindo '%s' no slot %d.\n",
+           ring->name, ring->faults, (long long)event->index + 1, pageName(event->page), oldPage, event->slot);
+    if (ring->frames) {
+        ring->frames[event->slot] = event->page;
+        displayFrameState(ring->name, ring->numFrames, ring->frames, event->page, event->victim, event->slot);
+    }
+}
+
+// esvazia o q tiver em cada anel; retorna qtos eventos tratou
+static long drainOnce() {
+    long handled = 0;
+    int count = __atomic_load_n(&numSources, __ATOMIC_ACQUIRE);
+    for (int s = 0; s < count; s++) {
+        LogRing* ring = sources[s];
+        uint32_t head = ring->head;
+        uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (binaryOut) {
+            // binario: o trecho todo de uma vez (em ate 2 pedaços qdo da a volta no anel)
+            while (head != tail) {
+                uint32_t start = head & (LOG_RING_SIZE - 1);
+                uint32_t count = tail - head;
+                if (count > LOG_RING_SIZE - start) count = LOG_RING_SIZE - start;
+                fwrite(&ring->events[start], sizeof(LogEvent), count, binaryOut);
+                head += count;
+                handled += count;
+                __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+            }
+            continue;
+        }
+        while (head != tail) {
+            const LogEvent* event = &ring->events[head & (LOG_RING_SIZE - 1)];
+            formatEvent(ring, event);
+            head++;
+            handled++;
+            // libera o espaço aos poucos p o produtor nao ficar esperando o anel inteiro
+            if ((head & 1023) == 0) __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+        }
+        __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+    }
+    return handled;
+}
+
+static void* drainLoop(void* arg) {
+    while (1) {
+        int stop = __atomic_load_n(&stopping, __ATOMIC_ACQUIRE);
+        if (drainOnce() == 0) {
+            if (stop) break; // o stop foi visto antes dessa passada vazia: nao chega mais nada
+            usleep(100);
+        }
+    }
+    return NULL;
+}
+
+// liga os logs; binaryPath NULL = texto no stdout, senao grava os eventos em binario (0 = ok)
+int eventLogStart(const char* binaryPath) {
+    if (running) return 0;
+    if (binaryPath) {
+        binaryOut = fopen(binaryPath, "wb");
+        if (!binaryOut) return -1;
+        setvbuf(binaryOut, NULL, _IOFBF, 1 << 20);
+        LogHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, LOG_MAGIC, 8);
+        header.version = LOG_VERSION;
+        header.eventSize = sizeof(LogEvent);
+        fwrite(&header, sizeof(header), 1, binaryOut);
+    }
+    stopping = 0;
+    if (pthread_create(&drainThread, NULL, drainLoop, NULL) != 0) {
+        perror("falha ao criar a thread de logs");
+        exit(1);
+    }
+    running = 1;
+    return 0;
+}
+
+int eventLogActive() {
+    return running;
+}
+
+// registra uma simulação q vai gerar eventos; -1 = logs desligados (ou simulações demais)
+int eventLogSource(const char* name, int numFrames) {
+    if (!running) return -1;
+    pthread_mutex_lock(&sourcesLock);
+    int id = -1;
+    if (numSources < MAX_LOG_SOURCES) {
+        LogRing* ring = (LogRing*)policyAlloc(1, sizeof(LogRing));
+        ring->events = (LogEvent*)policyAlloc(LOG_RING_SIZE, sizeof(LogEvent));
+        snprintf(ring->name, sizeof(ring->name), "%s", name);
+        ring->numFrames = numFrames;
+        if (g_didaticMode && !binaryOut) {
+            ring->frames = (uint32_t*)policyAlloc(numFrames, sizeof(uint32_t));
+            for (int i = 0; i < numFrames; i++) ring->frames[i] = PAGE_NONE;
+        }
+        id = numSources;
+        sources[id] = ring;
+        __atomic_store_n(&numSources, numSources + 1, __ATOMIC_RELEASE);
+    } else {
+        fprintf(stderr, "[aviso] simulações demais com log; a partir daqui sem log.\n");
+    }
+    pthread_mutex_unlock(&sourcesLock);
+    return id;
+}
+
+// caminho quente: copia o evento p o anel (so espera se a thread de fundo ficou um anel inteiro p tras)
+void eventLogFault(int source, long long index, uint32_t page, uint32_t victim, int slot) {
+    LogRing* ring = sources[source];
+    uint32_t tail = ring->tail;
+    while (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) >= LOG_RING_SIZE) usleep(50);
+    LogEvent* event = &ring->events[tail & (LOG_RING_SIZE - 1)];
+    event->index = index;
+    event->page = page;
+    event->victim = victim;
+    event->slot = slot;
+    event->source = (uint16_t)source;
+    event->reserved = 0;
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+// espera a thread de fundo tratar tudo o q ja foi gravado
+// (antes de imprimir direto no stdout, ou de registrar pags novas no --stream)
+void eventLogFlush() {
+    if (!running) return;
+    // so ate o tail de agora: com varias threads gravando, esperar o anel ficar vazio poderia nao acabar
+    int count = __atomic_load_n(&numSources, __ATOMIC_ACQUIRE);
+    for (int s = 0; s < count; s++) {
+        LogRing* ring = sources[s];
+        uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        while ((int32_t)(tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) > 0) usleep(50);
+    }
+    if (!binaryOut) fflush(stdout);
+}
+
+// para a thread de fundo; no --log fecha o arquivo com a tabela de simulações e o dicionario de pags
+void eventLogStop() {
+    if (!running) return;
+    __atomic_store_n(&stopping, 1, __ATOMIC_RELEASE);
+    pthread_join(drainThread, NULL);
+    running = 0;
+
+    if (binaryOut) {
+        LogTrailer trailer;
+        memset(&trailer, 0, sizeof(trailer));
+        trailer.footerOffset = (uint64_t)ftell(binaryOut);
+        trailer.numSources = numSources;
+        trailer.numPages = g_pageCount;
+        memcpy(trailer.magic, LOG_MAGIC, 8);
+        for (int s = 0; s < numSources; s++) {
+            fwrite(sources[s]->name, sizeof(sources[s]->name), 1, binaryOut);
+            int32_t frames = sources[s]->numFrames;
+            fwrite(&frames, sizeof(frames), 1, binaryOut);
+        }
+        char name[MAX_PAGE_ID_LEN];
+        for (int p = 0; p < g_pageCount; p++) {
+            memset(name, 0, sizeof(name));
+            snprintf(name, sizeof(name), "%s", pageName(p));
+            fwrite(name, sizeof(name), 1, binaryOut);
+        }
+        fwrite(&trailer, sizeof(trailer), 1, binaryOut);
+        if (ferror(binaryOut)) perror("[aviso] falha ao gravar o log");
+        fclose(binaryOut);
+        binaryOut = NULL;
+    }
+
+    for (int s = 0; s < numSources; s++) {
+        free(sources[s]->events);
+        free(sources[s]->frames);
+        free(sources[s]);
+    }
+    numSources = 0;
+}
+
+// --decode: converte o log binario no mesmo texto do -v (showFrames = tb o estado dos frames)
+// os erros ja saem aqui mesmo; -1 = arquivo faltando, incompleto ou corrompido
+int decodeEventLog(const char* path, int showFrames) {
+    FILE* in = fopen(path, "rb");
+    if (!in) {
+        perror("[ERRO] ao abrir o log");
+        return -1;
+    }
+
+    LogHeader header;
+    LogTrailer trailer;
+    if (fread(&header, sizeof(header), 1, in) != 1 || memcmp(header.magic, LOG_MAGIC, 8) != 0 ||
+        header.version != LOG_VERSION || header.eventSize != sizeof(LogEvent) ||
+        fseek(in, -(long)sizeof(trailer), SEEK_END) != 0 || fread(&trailer, sizeof(trailer), 1, in) != 1 ||
+        memcmp(trailer.magic, LOG_MAGIC, 8) != 0 || trailer.numSources > MAX_LOG_SOURCES) {
+        fprintf(stderr, "[ERRO] %s não é um log completo (a execução terminou?).\n", path);
+        fclose(in);
+        return -1;
+    }
+
+    // dicionario de pags direto na tabela hash, na ordem dos indices (como no .mtr)
+    fseek(in, (long)trailer.footerOffset, SEEK_SET);
+    LogRing rings[MAX_LOG_SOURCES];
+    memset(rings, 0, sizeof(rings));
+    for (uint32_t s = 0; s < trailer.numSources; s++) {
+        int32_t frames;
+        if (fread(rings[s].name, sizeof(rings[s].name), 1, in) != 1 || fread(&frames, sizeof(frames), 1, in) != 1) break;
+        rings[s].name[sizeof(rings[s].name) - 1] = '\0';
+        rings[s].numFrames = frames;
+        if (showFrames) {
+            rings[s].frames = (uint32_t*)policyAlloc(frames, sizeof(uint32_t));
+            for (int i = 0; i < frames; i++) rings[s].frames[i] = PAGE_NONE;
+        }
+    }
+    char name[MAX_PAGE_ID_LEN];
+    for (uint32_t p = 0; p < trailer.numPages && fread(name, sizeof(name), 1, in) == 1; p++) {
+        name[MAX_PAGE_ID_LEN - 1] = '\0';
+        registerPage(name);
+    }
+
+    // com --threads os eventos das simulações ficam misturados no arquivo: uma passada por simulação
+    // deixa cada uma inteira e na ordem, como no -v
+    long long numEvents = (long long)(trailer.footerOffset - sizeof(header)) / sizeof(LogEvent);
+    int invalid = 0;
+    for (uint32_t s = 0; s < trailer.numSources && !invalid; s++) {
+        fseek(in, sizeof(header), SEEK_SET);
+        LogEvent event;
+        for (long long e = 0; e < numEvents && fread(&event, sizeof(event), 1, in) == 1; e++) {
+            if (event.source >= trailer.numSources || event.page >= trailer.numPages ||
+                (event.victim != PAGE_NONE && event.victim >= trailer.numPages) || event.slot < 0 ||
+                event.slot >= rings[event.source].numFrames) {
+                fprintf(stderr, "[ERRO] evento %lld inválido no log.\n", e);
+                invalid = 1;
+                break;
+            }
+            if (event.source == s) formatEvent(&rings[s], &event);
+        }
+    }
+
+    for (uint32_t s = 0; s < trailer.numSources; s++) free(rings[s].frames);
+    fclose(in);
+    return invalid ? -1 : 0;
+}
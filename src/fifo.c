@@ -0,0 +1,67 @@
+#include "simulator.h"
+
+// FIFO: substitui a pagina que esta ha mais tempo na memoria
+// fila circular das pags na ordem de chegada; hit nao muda nada
+
+typedef struct {
+    uint32_t* queue;
+    int capacity;
+    int head; // mais antiga
+    int size;
+} FifoState;
+
+static void* fifoCreate(int numFrames, int numPages) {
+    FifoState* state = (FifoState*)policyAlloc(1, sizeof(FifoState));
+    state->queue = (uint32_t*)policyAlloc(numFrames, sizeof(uint32_t));
+    state->capacity = numFrames;
+    return state;
+}
+
+static uint32_t fifoChooseVictim(void* raw, uint32_t page) {
+    FifoState* state = (FifoState*)raw;
+    uint32_t victim = state->queue[state->head];
+    state->head = (state->head + 1) % state->capacity;
+    state->size--;
+    return victim;
+}
+
+static void fifoOnMiss(void* raw, uint32_t page, int slot, long long nextUse) {
+    FifoState* state = (FifoState*)raw;
+    state->queue[(state->head + state->size) % state->capacity] = page;
+    state->size++;
+}
+
+static void fifoDestroy(void* raw) {
+    FifoState* state = (FifoState*)raw;
+    free(state->queue);
+    free(state);
+}
+
+static void fifoSave(void* raw, int usedFrames, int numPages, FILE* out) {
+    FifoState* state = (FifoState*)raw;
+    checkpointWrite(out, &state->head, sizeof(int));
+    checkpointWrite(out, &state->size, sizeof(int));
+    checkpointWrite(out, state->queue, state->capacity * sizeof(uint32_t));
+}
+
+// a fila tem q ter cada pag residente uma vez so
+static int fifoRestore(void* raw, int usedFrames, int numPages, const int* slotOf, FILE* in) {
+    FifoState* state = (FifoState*)raw;
+    if (checkpointRead(in, &state->head, sizeof(int)) != 0 || checkpointRead(in, &state->size, sizeof(int)) != 0) return -1;
+    if (state->head < 0 || state->head >= state->capacity || state->size != usedFrames) return -1;
+    if (checkpointRead(in, state->queue, state->capacity * sizeof(uint32_t)) != 0) return -1;
+    unsigned char* seen = (unsigned char*)policyAlloc(state->capacity, sizeof(unsigned char)); // por slot
+    int result = 0;
+    for (int i = 0; i < state->size && result == 0; i++) {
+        uint32_t page = state->queue[(state->head + i) % state->capacity];
+        if (page >= (uint32_t)numPages || slotOf[page] < 0 || seen[slotOf[page]]) result = -1;
+        else seen[slotOf[page]] = 1;
+    }
+    free(seen);
+    return result;
+}
+
+const ReplacementPolicy fifoPolicy = {
+    "fifo", "FIFO", 0, fifoCreate, NULL, fifoChooseVictim, fifoOnMiss, fifoDestroy, NULL, NULL,
+    fifoSave, fifoRestore
+};
@@ -1,131 +1,235 @@
 #include "simulator.h"
 
 int g_pageCount = 0;
-HashNode* hashTable[HASH_TABLE_SIZE];
+HashNode** g_pageNodes = NULL;
+
+// tabela hash de enderecamento aberto (sondagem linear) com a chave guardada no proprio slot
+// cresce sozinha, entao o custo de busca nao depende de qtas pags distintas o trace tem
+// o programa usa uma so (a global, por tras do registerPage); o libmemsim tem uma por contexto
+static PageTable globalPages;
 
 // hash para mapear o id da página a um indice na tabela hash
+// djb2 + mistura final (fmix32) p espalhar os bits baixos, q sao os usados pela mascara
 unsigned int hashOptimize(const char* key) {
-    unsigned long int value = 5381;
+    uint32_t value = 5381;
     int c;
     while ((c = *key++)) {
         value = ((value << 5) + value) + c; // value * 33 + c
     }
-    return value % HASH_TABLE_SIZE;
+    value ^= value >> 16;
+    value *= 0x85ebca6b;
+    value ^= value >> 13;
+    value *= 0xc2b2ae35;
+    value ^= value >> 16;
+    return value;
 }
 
-//inicializa a tabela hash
-void hashInit() {
-    g_pageCount = 0;
-    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
-        hashTable[i] = NULL;
+static void pageTableAlloc(PageTable* table, uint32_t capacity) {
+    table->slots = (PageSlot*)malloc(capacity * sizeof(PageSlot));
+    if (!table->slots) {
+        perror("falha ao alocar memoria pra tabela hash");
+        exit(1);
     }
+    for (uint32_t i = 0; i < capacity; i++) table->slots[i].page = PAGE_NONE;
+    table->mask = capacity - 1;
 }
 
-// encontra um nodo na tabela hash (funçao aux)
-HashNode* findNode(const char* page_id) {
-    unsigned int index = hashOptimize(page_id);
-    HashNode* current = hashTable[index];
-    while (current) {
-        if (strcmp(current->page_id, page_id) == 0) {
-            return current;
-        }
-        current = current->next;
+// slot onde a chave ta ou onde ela entraria
+static PageSlot* probe(const PageTable* table, const char* key) {
+    uint32_t index = hashOptimize(key) & table->mask;
+    int length = 1;
+    while (table->slots[index].page != PAGE_NONE && memcmp(table->slots[index].key, key, MAX_PAGE_ID_LEN) != 0) {
+        index = (index + 1) & table->mask;
+        length++;
     }
-    return NULL;
+    if (table->counters) statsProbe(table->counters, length);
+    return &table->slots[index];
+}
+
+// dobra a tabela e reinsere as chaves quando passa de 70% de ocupacao
+static void pageTableGrow(PageTable* table) {
+    PageSlot* old = table->slots;
+    uint32_t oldCapacity = table->mask + 1;
+    pageTableAlloc(table, oldCapacity * 2);
+    for (uint32_t i = 0; i < oldCapacity; i++) {
+        if (old[i].page != PAGE_NONE) *probe(table, old[i].key) = old[i];
+    }
+    free(old);
+}
+
+// copia o id p uma chave de tamanho fixo completada com '\0'
+static void makeKey(char* key, const char* page_id) {
+    memset(key, 0, MAX_PAGE_ID_LEN);
+    strncpy(key, page_id, MAX_PAGE_ID_LEN - 1);
+}
+
+// os nodos saem de arena (liberada junto no pageTableFree)
+void pageTableInit(PageTable* table, Arena* arena) {
+    table->nodes = NULL;
+    table->count = 0;
+    table->capacity = 0;
+    table->arena = arena;
+    table->counters = NULL;
+    pageTableAlloc(table, HASH_TABLE_INITIAL_SIZE);
+    arenaInit(arena, ARENA_CHUNK_SIZE);
+    poolInit(&table->nodePool, arena, sizeof(HashNode));
 }
 
+// indice denso do id (PAGE_NONE = nunca registrado)
+uint32_t pageTableFind(const PageTable* table, const char* page_id) {
+    char key[MAX_PAGE_ID_LEN];
+    makeKey(key, page_id);
+    return probe(table, key)->page;
+}
+
+const char* pageTableName(const PageTable* table, uint32_t page) {
+    return table->nodes[page]->page_id;
+}
 
 //registrar uma página na lista de paginas conhecida (tabela hash)
-void registerPage(const char* page_id) {
-    if (findNode(page_id) != NULL) {
-        return; // pag ja registrada
+// retorna o indice denso da pagina, q eh o q a simulação usa dali em diante
+uint32_t pageTableIntern(PageTable* table, const char* page_id) {
+    char key[MAX_PAGE_ID_LEN];
+    makeKey(key, page_id);
+    PageSlot* slot = probe(table, key);
+    if (slot->page != PAGE_NONE) {
+        return slot->page; // pag ja registrada
+    }
+
+    // cresce o vetor de nodos indexado pelo indice denso
+    if (table->count >= table->capacity) {
+        table->capacity = (table->capacity == 0) ? 1024 : table->capacity * 2;
+        table->nodes = (HashNode**)realloc(table->nodes, table->capacity * sizeof(HashNode*));
+        if (!table->nodes) {
+            perror("falha ao realocar o vetor de paginas");
+            exit(1);
+        }
     }
 
+    HashNode* newNode = (HashNode*)poolAlloc(&table->nodePool);
+
+    // preenche as infromações da nova pag
+    memcpy(newNode->page_id, key, MAX_PAGE_ID_LEN);
+    newNode->index = (uint32_t)table->count;
+
+    memcpy(slot->key, key, MAX_PAGE_ID_LEN);
+    slot->page = newNode->index;
+
     // pag nova = incrementa contador
-    g_pageCount++;
+    table->nodes[table->count++] = newNode;
+    if ((uint32_t)table->count * 10 > (table->mask + 1) * 7) pageTableGrow(table);
+    return newNode->index;
+}
 
-    unsigned int index = hashOptimize(page_id);
-    HashNode* newNode = (HashNode*)malloc(sizeof(HashNode));
-    if (!newNode) {
-        perror("falha ao alocar memoria pra tabela hash");
+// libera a tabela e os nodos (a arena inteira vai junto)
+void pageTableFree(PageTable* table) {
+    arenaRelease(table->arena);
+    free(table->nodes);
+    free(table->slots);
+    table->nodes = NULL;
+    table->slots = NULL;
+    table->count = 0;
+    table->capacity = 0;
+    table->mask = 0;
+}
+
+//inicializa a tabela hash (se ja tinha uma, libera antes p nao vazar)
+void hashInit() {
+    if (globalPages.slots) pageTableFree(&globalPages);
+    pageTableInit(&globalPages, &g_arena);
+    globalPages.counters = g_stats ? &g_counters : NULL;
+    g_pageCount = 0;
+    g_pageNodes = NULL;
+    g_counters.tableCapacity = globalPages.mask + 1;
+}
+
+// encontra um nodo na tabela hash (funçao aux)
+HashNode* findNode(const char* page_id) {
+    uint32_t page = pageTableFind(&globalPages, page_id);
+    return (page != PAGE_NONE) ? globalPages.nodes[page] : NULL;
+}
+
+
+// nodo a partir do indice denso (sem hash nem strcmp)
+HashNode* pageNode(uint32_t page) {
+    return globalPages.nodes[page];
+}
+
+// id original da pagina, usado so na hora de reportar
+const char* pageName(uint32_t page) {
+    return globalPages.nodes[page]->page_id;
+}
+
+// registra na tabela global e atualiza g_pageCount / g_pageNodes
+static uint32_t internPage(const char* page_id) {
+    uint32_t page = pageTableIntern(&globalPages, page_id);
+    g_pageCount = globalPages.count;
+    g_pageNodes = globalPages.nodes;
+    return page;
+}
+
+uint32_t registerPage(const char* page_id) {
+    if (!g_stats) return internPage(page_id);
+
+    // com --stats mede o tempo gasto aqui dentro (separado da leitura do arquivo)
+    double start = wallClock();
+    uint32_t page = internPage(page_id);
+    g_counters.registerSeconds += wallClock() - start;
+    g_counters.registerCalls++;
+    g_counters.tableCapacity = globalPages.mask + 1;
+    return page;
+}
+
+// passada de tras pra frente: nextUse[i] = indice do proximo acesso a mesma pag depois de i
+// uma unica alocacao contigua, O(n), sem vetor de usos futuros por pagina
+// numPages = qtde de indices densos q aparecem na sequencia
+int* computeNextUse(const PageAccess* accessSequence, int numAccesses, int numPages) {
+    int* nextUse = (int*)malloc((numAccesses > 0 ? numAccesses : 1) * sizeof(int));
+    int* lastSeen = (int*)malloc((numPages > 0 ? numPages : 1) * sizeof(int)); // acesso mais proximo ja visto de cada pag
+    if (!nextUse || !lastSeen) {
+        perror("falha ao alocar memoria para usos futuros");
         exit(1);
     }
+    for (int p = 0; p < numPages; p++) lastSeen[p] = INT_MAX;
 
-    // preenche as infromações da nova pag
-    strcpy(newNode->page_id, page_id);
-    newNode->fifoLoads = 0;
-    newNode->optimalLoads = 0;
-
-    // inicializa campos de pre processamento
-    newNode->futureUses = NULL;
-    newNode->numFutureUses = 0;
-    newNode->futureUsesCapacity = 0;
-    newNode->nextUsePointer = 0;
+    for (int i = numAccesses - 1; i >= 0; i--) {
+        uint32_t page = accessSequence[i].page;
+        nextUse[i] = lastSeen[page];
+        lastSeen[page] = i;
+    }
 
-    newNode->next = hashTable[index];
-    hashTable[index] = newNode;
+    free(lastSeen);
+    return nextUse;
 }
 
 // pre processa os acessos para o algoritmo otimo
-void preprocessOptimal(PageAccess* accessSequence, int numAccesses) {
+int* preprocessOptimal(PageAccess* accessSequence, int numAccesses) {
     printf("[OTIMO] iniciando pre processamento do arquivo de referencias...\n");
-    for (int i = 0; i < numAccesses; i++) {
-        HashNode* node = findNode(accessSequence[i].page_id);
-        if (node) {
-            //se o array de usos futuros ta cheio, realoca com mais espaço
-            if (node->numFutureUses >= node->futureUsesCapacity) {
-                node->futureUsesCapacity = (node->futureUsesCapacity == 0) ? 8 : node->futureUsesCapacity * 2;
-                node->futureUses = (int*)realloc(node->futureUses, node->futureUsesCapacity * sizeof(int));
-                if (!node->futureUses) {
-                    perror("falha ao realocar memoria para usos futuros");
-                    exit(1);
-                }
-            }
-            // add o indice do acesso atual ao array
-            node->futureUses[node->numFutureUses++] = i;
-        }
-    }
-     printf("[OTIMO] pre processamento concluido!\n");
-}
-
-// contar quantas vezes cada página foi carregada na memória
-// objetivo: comparar o desempenho dos algoritmos
-void incrementLoadCount(const char* page_id, const char* algorithm) {
-    HashNode* current = findNode(page_id);
-    if (current) {
-        if (strcmp(algorithm, "fifo") == 0) {
-            current->fifoLoads++;
-        } else if (strcmp(algorithm, "optimal") == 0) {
-            current->optimalLoads++;
-        }
-    }
+    int* nextUse = computeNextUse(accessSequence, numAccesses, g_pageCount);
+    printf("[OTIMO] pre processamento concluido!\n");
+    return nextUse;
 }
 
-//prita toda tabela de carregamento
-void loadSummary() {
+//prita toda tabela de carregamento (na ordem em q as pags apareceram no arquivo)
+// uma coluna por politica q rodou
+void loadSummary(const char** names, int** loads, int numColumns) {
     printf("\n--- carregamentos por página ---\n");
-    printf("%-10s %-10s %-10s\n", "página", "otimo", "fifo");
-    printf("----------------------------------\n");
-    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
-        HashNode* current = hashTable[i];
-        while (current) {
-            printf("%-10s %-10d %-10d\n", current-> page_id, current-> optimalLoads, current-> fifoLoads);
-            current = current->next;
-        }
+    printf("%-10s", "página");
+    for (int c = 0; c < numColumns; c++) printf(" %-10s", names[c]);
+    printf("\n");
+    printf("------------");
+    for (int c = 0; c < numColumns; c++) printf("-----------");
+    printf("\n");
+    for (int i = 0; i < g_pageCount; i++) {
+        printf("%-10s", g_pageNodes[i]->page_id);
+        for (int c = 0; c < numColumns; c++) printf(" %-10d", loads[c][i]);
+        printf("\n");
     }
 }
 
-// libera a memória da tabela hash
+// libera a memória da tabela hash (os nodos saem todos juntos com a arena)
 void cleanHashTable() {
-    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
-        HashNode* current = hashTable[i];
-        while (current) {
-            HashNode* temp = current;
-            current = current->next;
-            // libera a memória do array de usos futuros
-            free(temp->futureUses);
-            free(temp);
-        }
-        hashTable[i] = NULL;
-    }
-}
\ No newline at end of file
+    pageTableFree(&globalPages);
+    g_pageNodes = NULL;
+    g_pageCount = 0;
+}
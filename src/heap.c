@@ -0,0 +1,85 @@
+#include "simulator.h"
+
+// heap de maximo indexado pelos slots da memoria fisica
+// a chave de cada slot eh o proximo uso da pag q ta nele; o topo eh a vitima do otimo
+
+// slot a tem prioridade sobre b? empate vai pro menor slot (igual a varredura antiga)
+static int heapAbove(const MaxHeap* heap, int a, int b) {
+    if (heap->key[a] != heap->key[b]) return heap->key[a] > heap->key[b];
+    return a < b;
+}
+
+static void heapSwap(MaxHeap* heap, int i, int j) {
+    int a = heap->slots[i];
+    int b = heap->slots[j];
+    heap->slots[i] = b;
+    heap->slots[j] = a;
+    heap->position[b] = i;
+    heap->position[a] = j;
+    heap->steps++;
+}
+
+static void heapSiftUp(MaxHeap* heap, int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!heapAbove(heap, heap->slots[i], heap->slots[parent])) break;
+        heapSwap(heap, i, parent);
+        i = parent;
+    }
+}
+
+static void heapSiftDown(MaxHeap* heap, int i) {
+    while (1) {
+        int left = 2 * i + 1;
+        int right = left + 1;
+        int largest = i;
+
+        if (left < heap->size && heapAbove(heap, heap->slots[left], heap->slots[largest])) largest = left;
+        if (right < heap->size && heapAbove(heap, heap->slots[right], heap->slots[largest])) largest = right;
+        if (largest == i) break;
+
+        heapSwap(heap, i, largest);
+        i = largest;
+    }
+}
+
+void heapInit(MaxHeap* heap, int capacity) {
+    heap->slots = (int*)malloc(capacity * sizeof(int));
+    heap->position = (int*)malloc(capacity * sizeof(int));
+    heap->key = (long long*)malloc(capacity * sizeof(long long));
+    if (!heap->slots || !heap->position || !heap->key) {
+        perror("falha ao alocar memoria para o heap do otimo");
+        exit(1);
+    }
+    heap->size = 0;
+    heap->steps = 0;
+}
+
+// insere um slot novo com a chave dada
+void heapPush(MaxHeap* heap, int slot, long long key) {
+    int i = heap->size++;
+    heap->slots[i] = slot;
+    heap->position[slot] = i;
+    heap->key[slot] = key;
+    heapSiftUp(heap, i);
+}
+
+// troca a chave de um slot q ja ta no heap e reposiciona
+void heapUpdate(MaxHeap* heap, int slot, long long key) {
+    long long oldKey = heap->key[slot];
+    heap->key[slot] = key;
+    if (key > oldKey) heapSiftUp(heap, heap->position[slot]);
+    else heapSiftDown(heap, heap->position[slot]);
+}
+
+// slot com o uso mais distante (nao remove)
+int heapTop(const MaxHeap* heap) {
+    return heap->slots[0];
+}
+
+void heapFree(MaxHeap* heap) {
+    free(heap->slots);
+    free(heap->position);
+    free(heap->key);
+    heap->size = 0;
+}
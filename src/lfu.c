@@ -0,0 +1,141 @@
+#include "simulator.h"
+
+// LFU: substitui a pag com menos acessos desde q entrou (empate = a usada ha mais tempo)
+// O(1): lista de baldes de frequencia em ordem crescente, cada balde com sua lista de pags
+// os baldes vem de um pool na arena da propria simulação
+
+typedef struct FrequencyBucket {
+    long long frequency;
+    PageList pages; // mais recente na frente
+    struct FrequencyBucket* prev;
+    struct FrequencyBucket* next;
+} FrequencyBucket;
+
+typedef struct {
+    PageLinks links;
+    FrequencyBucket** bucketOf; // balde de cada pag residente
+    FrequencyBucket* lowest;    // balde de menor frequencia
+    Arena arena;
+    Pool bucketPool;
+} LfuState;
+
+static void* lfuCreate(int numFrames, int numPages) {
+    LfuState* state = (LfuState*)policyAlloc(1, sizeof(LfuState));
+    pageLinksInit(&state->links, numPages);
+    state->bucketOf = (FrequencyBucket**)policyAlloc(numPages, sizeof(FrequencyBucket*));
+    arenaInit(&state->arena, 64 * 1024);
+    poolInit(&state->bucketPool, &state->arena, sizeof(FrequencyBucket));
+    return state;
+}
+
+// cria um balde de frequencia logo depois de prev (prev NULL = no inicio)
+static FrequencyBucket* bucketInsertAfter(LfuState* state, FrequencyBucket* prev, long long frequency) {
+    FrequencyBucket* bucket = (FrequencyBucket*)poolAlloc(&state->bucketPool);
+    bucket->frequency = frequency;
+    pageListInit(&bucket->pages);
+    bucket->prev = prev;
+    bucket->next = prev ? prev->next : state->lowest;
+    if (bucket->next) bucket->next->prev = bucket;
+    if (prev) prev->next = bucket;
+    else state->lowest = bucket;
+    return bucket;
+}
+
+static void bucketRemoveIfEmpty(LfuState* state, FrequencyBucket* bucket) {
+    if (bucket->pages.size > 0) return;
+    if (bucket->prev) bucket->prev->next = bucket->next;
+    else state->lowest = bucket->next;
+    if (bucket->next) bucket->next->prev = bucket->prev;
+    poolFree(&state->bucketPool, bucket);
+}
+
+static void lfuOnHit(void* raw, uint32_t page, int slot, long long nextUse) {
+    LfuState* state = (LfuState*)raw;
+    FrequencyBucket* bucket = state->bucketOf[page];
+    FrequencyBucket* next = bucket->next;
+
+    if (!next || next->frequency != bucket->frequency + 1) {
+        next = bucketInsertAfter(state, bucket, bucket->frequency + 1);
+    }
+    pageListRemove(&bucket->pages, &state->links, page);
+    pageListPushFront(&next->pages, &state->links, page);
+    state->bucketOf[page] = next;
+    bucketRemoveIfEmpty(state, bucket);
+}
+
+static uint32_t lfuChooseVictim(void* raw, uint32_t page) {
+    LfuState* state = (LfuState*)raw;
+    FrequencyBucket* bucket = state->lowest;
+    uint32_t victim = pageListPopBack(&bucket->pages, &state->links);
+    state->bucketOf[victim] = NULL;
+    bucketRemoveIfEmpty(state, bucket);
+    return victim;
+}
+
+static void lfuOnMiss(void* raw, uint32_t page, int slot, long long nextUse) {
+    LfuState* state = (LfuState*)raw;
+    FrequencyBucket* bucket = state->lowest;
+    if (!bucket || bucket->frequency != 1) bucket = bucketInsertAfter(state, NULL, 1);
+    pageListPushFront(&bucket->pages, &state->links, page);
+    state->bucketOf[page] = bucket;
+}
+
+static void lfuDestroy(void* raw) {
+    LfuState* state = (LfuState*)raw;
+    pageLinksFree(&state->links);
+    free(state->bucketOf);
+    arenaRelease(&state->arena);
+    free(state);
+}
+
+static void lfuGrow(void* raw, int oldPages, int numPages) {
+    LfuState* state = (LfuState*)raw;
+    pageLinksGrow(&state->links, oldPages, numPages);
+    state->bucketOf = (FrequencyBucket**)policyRealloc(state->bucketOf, oldPages, numPages, sizeof(FrequencyBucket*));
+}
+
+// checkpoint: os baldes tem ponteiros, entao vao como (frequencia, pags da mais antiga p a mais nova)
+// e o restore refaz as listas na mesma ordem
+static void lfuSave(void* raw, int usedFrames, int numPages, FILE* out) {
+    LfuState* state = (LfuState*)raw;
+    int numBuckets = 0;
+    for (FrequencyBucket* bucket = state->lowest; bucket; bucket = bucket->next) numBuckets++;
+    checkpointWrite(out, &numBuckets, sizeof(int));
+    for (FrequencyBucket* bucket = state->lowest; bucket; bucket = bucket->next) {
+        checkpointWrite(out, &bucket->frequency, sizeof(long long));
+        checkpointWrite(out, &bucket->pages.size, sizeof(int));
+        for (uint32_t page = bucket->pages.tail; page != PAGE_NONE; page = state->links.prev[page]) {
+            checkpointWrite(out, &page, sizeof(uint32_t));
+        }
+    }
+}
+
+static int lfuRestore(void* raw, int usedFrames, int numPages, const int* slotOf, FILE* in) {
+    LfuState* state = (LfuState*)raw;
+    int numBuckets, total = 0;
+    if (checkpointRead(in, &numBuckets, sizeof(int)) != 0 || numBuckets < 0 || numBuckets > usedFrames) return -1;
+    FrequencyBucket* last = NULL;
+    for (int b = 0; b < numBuckets; b++) {
+        long long frequency;
+        int size;
+        if (checkpointRead(in, &frequency, sizeof(long long)) != 0 || checkpointRead(in, &size, sizeof(int)) != 0) return -1;
+        if (size <= 0 || (total += size) > usedFrames) return -1;
+        last = bucketInsertAfter(state, last, frequency);
+        for (int i = 0; i < size; i++) {
+            uint32_t page;
+            // so residentes, e cada uma uma vez (repetida fecharia um ciclo nas listas)
+            if (checkpointRead(in, &page, sizeof(uint32_t)) != 0 || page >= (uint32_t)numPages || slotOf[page] < 0 ||
+                state->bucketOf[page]) {
+                return -1;
+            }
+            pageListPushFront(&last->pages, &state->links, page);
+            state->bucketOf[page] = last;
+        }
+    }
+    return (total == usedFrames) ? 0 : -1;
+}
+
+const ReplacementPolicy lfuPolicy = {
+    "lfu", "LFU", 0, lfuCreate, lfuOnHit, lfuChooseVictim, lfuOnMiss, lfuDestroy, NULL, lfuGrow,
+    lfuSave, lfuRestore
+};
@@ -0,0 +1,64 @@
+#include "simulator.h"
+
+// LRU: substitui a pag usada ha mais tempo
+// lista duplamente ligada (mais recente na frente), tudo O(1)
+
+typedef struct {
+    PageLinks links;
+    PageList list;
+} LruState;
+
+static void* lruCreate(int numFrames, int numPages) {
+    LruState* state = (LruState*)policyAlloc(1, sizeof(LruState));
+    pageLinksInit(&state->links, numPages);
+    pageListInit(&state->list);
+    return state;
+}
+
+static void lruOnHit(void* raw, uint32_t page, int slot, long long nextUse) {
+    LruState* state = (LruState*)raw;
+    if (state->list.head == page) return;
+    pageListRemove(&state->list, &state->links, page);
+    pageListPushFront(&state->list, &state->links, page);
+}
+
+static uint32_t lruChooseVictim(void* raw, uint32_t page) {
+    LruState* state = (LruState*)raw;
+    return pageListPopBack(&state->list, &state->links);
+}
+
+static void lruOnMiss(void* raw, uint32_t page, int slot, long long nextUse) {
+    LruState* state = (LruState*)raw;
+    pageListPushFront(&state->list, &state->links, page);
+}
+
+static void lruDestroy(void* raw) {
+    LruState* state = (LruState*)raw;
+    pageLinksFree(&state->links);
+    free(state);
+}
+
+static void lruGrow(void* raw, int oldPages, int numPages) {
+    LruState* state = (LruState*)raw;
+    pageLinksGrow(&state->links, oldPages, numPages);
+}
+
+static void lruSave(void* raw, int usedFrames, int numPages, FILE* out) {
+    LruState* state = (LruState*)raw;
+    checkpointWrite(out, &state->list, sizeof(PageList));
+    pageLinksSave(&state->links, numPages, out);
+}
+
+// a lista tem q ter exatamente as pags residentes
+static int lruRestore(void* raw, int usedFrames, int numPages, const int* slotOf, FILE* in) {
+    LruState* state = (LruState*)raw;
+    if (checkpointRead(in, &state->list, sizeof(PageList)) != 0) return -1;
+    if (pageLinksRestore(&state->links, numPages, in) != 0) return -1;
+    if (state->list.size != usedFrames) return -1;
+    return pageListCheck(&state->list, &state->links, numPages, usedFrames, slotOf, 1, NULL, 0);
+}
+
+const ReplacementPolicy lruPolicy = {
+    "lru", "LRU", 0, lruCreate, lruOnHit, lruChooseVictim, lruOnMiss, lruDestroy, NULL, lruGrow,
+    lruSave, lruRestore
+};
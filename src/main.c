@@ -1,43 +1,392 @@
 // p executar: make / make clean |   ./bin/main.exe <arq.txt> <memoria> // no modo didatico: -v
+// curva de faltas: ./bin/main.exe <arq.txt> <memoria max> --mrc=<saida.csv> [--sizes=8KB,16KB,...]
+// curva aproximada por amostragem: ... --mrc=<saida.csv> --sample=1% (com --stream so a aproximada)
+// converter p binario: ./bin/main.exe --convert <arq.txt> <saida.mtr> [--compact]
+// varios tamanhos em paralelo: ./bin/main.exe <arq.txt> <memoria> --sizes=8MB,16MB,... [--threads=N]
+// outras politicas: ./bin/main.exe <arq.txt> <memoria> --policy=otimo,fifo,lru,clock,lfu,arc,2q (ou all)
+// onde vai o tempo: ./bin/main.exe <arq.txt> <memoria> --stats
+// por processo: ./bin/main.exe <arq.txt> <memoria> --multiprog=fixo|proporcional [--policy=...]
+// custo de tradução: ./bin/main.exe <arq.txt> <memoria> --tlb=64x4[,lru|fifo|random] [--levels=2|3|4]
+// outro tamanho de pag: ... --page-size=2MB  |  regioes quentes em pags enormes: ... --huge=2MB[,25%]
+// working set W(t, tau) e PFF no tempo: ./bin/main.exe <arq.txt> <memoria> --ws=<saida.csv>[,<pontos>] [--tau=1000,10000,100000]
+// instruções e dados em pools separados: ... --split=fixo[=25%]|adaptativo
+// pags mais recarregadas: ... --top=20[,aprox[=<contadores>]] [--top-out=<saida.csv|.json>]
+// carregamentos de todas as pags sem a pergunta final (p scripts): ... --loads
+// logs das faltas em binario (rapido): ... --log=<arq>  e depois ./bin/main.exe --decode <arq> [--frames]
+// execuções longas: ... --checkpoint=<arq>[,<acessos>]  e depois o mesmo comando com --resume (ou --resume=<outro arq>)
+// trace maior q a memoria (so politicas online): ./bin/main.exe <arq.txt> <memoria> --stream  |  ... | ./bin/main.exe - <memoria>
+// direto do tracer: valgrind --tool=lackey --trace-mem=yes --log-fd=3 <prog> 3>&1 >/dev/null | ./bin/main.exe - <memoria> --format=lackey --report-every=5s
 
 #include "simulator.h"
+#include <unistd.h>
 
-// djb2 hash function
-unsigned int presenceHash(const char* key) {
-    unsigned long hash = 5381;
-    int c;
-    while ((c = *key++))
-        hash = ((hash << 5) + hash) + c;
-    return hash % HASH_TABLE_SIZE; // index = centro da tabela
+// subcomando --convert: le o trace em texto uma vez e grava o formato binario
+static int convertTrace(int argc, char* argv[]) {
+    if (argc < 4) {
+        printf("Uso: %s --convert <arquivo.txt> <saida.mtr> [--compact]\n", argv[0]);
+        return 1;
+    }
+    int compact = (argc > 4 && strcmp(argv[4], "--compact") == 0);
+
+    hashInit();
+    Trace trace;
+    if (loadTrace(argv[2], &trace, 0) != 0) {
+        perror("[ERRO] ao abrir o arquivo.");
+        return 1;
+    }
+    if (writeBinaryTrace(argv[3], &trace, compact) != 0) {
+        perror("[ERRO] ao gravar o trace binario");
+        return 1;
+    }
+    printf("%d acessos e %d páginas distintas gravados em %s.\n", trace.numAccesses, g_pageCount, argv[3]);
+
+    freeTrace(&trace);
+    cleanHashTable();
+    return 0;
+}
+
+// subcomando --decode: transforma o log binario do --log no texto do -v
+static int decodeLog(int argc, char* argv[]) {
+    if (argc < 3) {
+        printf("Uso: %s --decode <log> [--frames]\n", argv[0]);
+        return 1;
+    }
+    int showFrames = (argc > 3 && strcmp(argv[3], "--frames") == 0);
+
+    hashInit();
+    int result = decodeEventLog(argv[2], showFrames);
+    cleanHashTable();
+    return (result == 0) ? 0 : 1;
 }
 
 int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--convert") == 0) {
+        return convertTrace(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--decode") == 0) {
+        return decodeLog(argc, argv);
+    }
+
     // eespera os argumentos: ./programa <arquivo> <tamanho memoria>
     if (argc < 3) {
-        printf("Uso: %s <arquivo.txt> <memoria> [-v]\n", argv[0]);
+        printf("Uso: %s <arquivo.txt> <memoria> [-v] [--log=<arq>] [--mrc=<saida.csv>] [--sizes=<lista>] [--threads=N] [--policy=<lista>] [--stats] [--stream] [--format=padrao|lackey|perf] [--report-every=<acessos>|<seg>s] [--sample=<taxa>] [--multiprog=fixo|proporcional] [--tlb=<entradas>x<vias>] [--levels=N] [--page-size=<tam>] [--huge=<tam>[,<reserva>]] [--split=fixo|adaptativo[=<I%%>]] [--ws=<saida.csv>[,<pontos>]] [--tau=<lista>] [--checkpoint=<arq>[,<acessos>]] [--resume[=<arq>]] [--top=<K>[,aprox[=<contadores>]]] [--top-out=<arq>] [--loads]\n", argv[0]);
         return 1;
     }
 
     char* filename = argv[1];
     char* mem_size_str = argv[2];
+    char* mrcPath = NULL; // modo curva de faltas
+    char* wsPath = NULL; // modo working set / PFF
+    int wsPoints = WS_SERIES_POINTS;
+    int taus[MAX_WS_WINDOWS] = { WORKING_SET_WINDOW / 10, WORKING_SET_WINDOW, WORKING_SET_WINDOW * 10 };
+    int numTaus = 3;
+    int tauSet = 0;
+    char* sizeList = NULL;
+    double sampleRate = 1.0; // curva aproximada qdo < 1
+    int numThreads = defaultThreadCount();
+    const ReplacementPolicy* policies[MAX_POLICIES];
+    int numPolicies = parsePolicyList("otimo,fifo", policies, MAX_POLICIES); // padrao: os dois algoritmos originais
+    int streaming = (strcmp(filename, "-") == 0); // stdin so da p ler uma vez, entao eh sempre streaming
+    int multiprog = -1; // -1 = desligado, 0 = partições fixas, 1 = proporcionais ao working set
+    long long hugeSize = 0; // --huge: 0 = so um tamanho de pag
+    double hugeShare = 0.5; // fração da memoria reservada p as pags enormes
+    int split = -1; // --split: -1 = pool unico, 0 = pools I/D fixos, 1 = adaptativos
+    double splitShare = 0.5; // fração da memoria do pool I (a inicial no adaptativo)
+    char* logPath = NULL; // --log: faltas em binario em vez de texto
+    long long reportEvery = STREAM_SAMPLE_INTERVAL; // --report-every: relatorio parcial do streaming em acessos
+    double reportSeconds = 0; // ... ou em segundos (qdo reportEvery = 0)
+    int reportSet = 0;
+    int topK = 0; // --top: 0 = pergunta no fim se lista os carregamentos de todas as pags
+    int listLoads = 0; // --loads: lista os carregamentos sem perguntar
+    int topCounters = 0; // contadores do --top aproximado (0 = exato)
+    char* topPath = NULL;
+    char* checkpointPath = NULL;
+    char* resumePath = NULL;
+    int resume = 0;
+    int checkpointInterval = CHECKPOINT_INTERVAL;
+    TlbConfig tlbConfig = { 0, 0, TLB_LRU, MAX_PAGE_TABLE_LEVELS }; // entries 0 = sem simulação de TLB
+
+    for (int a = 3; a < argc; a++) {
+        if (strcmp(argv[a], "--verbose") == 0 || strcmp(argv[a], "-v") == 0) {
+            // ativa logs mais detalhados
+            g_verbose = 1;
+            printf("logs em tempo real executando.\n");
+        } else if (strncmp(argv[a], "--log=", 6) == 0) {
+            logPath = argv[a] + 6;
+            g_verbose = 1; // mesmas faltas do -v, so q gravadas em binario
+        } else if (strncmp(argv[a], "--top=", 6) == 0) {
+            // "20", "20,exato", "20,aprox" ou "20,aprox=10000"
+            char* end;
+            topK = (int)strtol(argv[a] + 6, &end, 10);
+            if (strcmp(end, ",aprox") == 0) {
+                topCounters = HEAVY_HITTER_COUNTERS;
+            } else if (strncmp(end, ",aprox=", 7) == 0) {
+                topCounters = (int)strtol(end + 7, &end, 10);
+                if (*end != '\0' || topCounters < 1) topK = 0;
+            } else if (*end != '\0' && strcmp(end, ",exato") != 0) {
+                topK = 0;
+            }
+            if (topK < 1) {
+                fprintf(stderr, "--top inválido: %s (use ex. 20, 20,exato, 20,aprox ou 20,aprox=10000)\n", argv[a] + 6);
+                return 1;
+            }
+            if (topCounters > 0 && topCounters < topK) topCounters = topK;
+        } else if (strncmp(argv[a], "--top-out=", 10) == 0) {
+            topPath = argv[a] + 10;
+        } else if (strcmp(argv[a], "--stats") == 0) {
+            g_stats = 1;
+        } else if (strcmp(argv[a], "--loads") == 0) {
+            listLoads = 1;
+        } else if (strcmp(argv[a], "--stream") == 0) {
+            streaming = 1;
+        } else if (strncmp(argv[a], "--format=", 9) == 0) {
+            if (strcmp(argv[a] + 9, "padrao") == 0) g_traceFormat = TRACE_TEXT;
+            else if (strcmp(argv[a] + 9, "lackey") == 0) g_traceFormat = TRACE_LACKEY;
+            else if (strcmp(argv[a] + 9, "perf") == 0) g_traceFormat = TRACE_PERF;
+            else {
+                fprintf(stderr, "formato de trace inválido: %s (use padrao, lackey ou perf)\n", argv[a] + 9);
+                return 1;
+            }
+        } else if (strncmp(argv[a], "--report-every=", 15) == 0) {
+            // "1000000" (acessos) ou "5s" (segundos)
+            char* end;
+            double value = strtod(argv[a] + 15, &end);
+            reportEvery = 0;
+            reportSeconds = 0;
+            if (strcmp(end, "s") == 0) reportSeconds = value;
+            else if (*end == '\0' && value >= 1 && value <= LLONG_MAX) reportEvery = (long long)value;
+            if (reportEvery < 1 && reportSeconds <= 0) {
+                fprintf(stderr, "intervalo de relatório inválido: %s (use ex. 1000000 ou 5s)\n", argv[a] + 15);
+                return 1;
+            }
+            reportSet = 1;
+        } else if (strncmp(argv[a], "--multiprog=", 12) == 0) {
+            if (strcmp(argv[a] + 12, "fixo") == 0) multiprog = 0;
+            else if (strcmp(argv[a] + 12, "proporcional") == 0) multiprog = 1;
+            else {
+                fprintf(stderr, "modo de multiprogramação inválido: %s (use fixo ou proporcional)\n", argv[a] + 12);
+                return 1;
+            }
+        } else if (strncmp(argv[a], "--split=", 8) == 0) {
+            // "fixo", "adaptativo", ou com a fatia do pool I: "fixo=25%"
+            const char* mode = argv[a] + 8;
+            size_t len = strcspn(mode, "=");
+            if (len == 4 && strncmp(mode, "fixo", 4) == 0) split = 0;
+            else if (len == 10 && strncmp(mode, "adaptativo", 10) == 0) split = 1;
+            else split = -2;
+            if (mode[len] == '=') {
+                char* end;
+                splitShare = strtod(mode + len + 1, &end) / 100.0;
+                if (*end == '%') end++;
+                if (*end != '\0') splitShare = -1;
+            }
+            if (split < -1 || splitShare <= 0 || splitShare >= 1) {
+                fprintf(stderr, "divisão I/D inválida: %s (use fixo, adaptativo, fixo=25%% ou adaptativo=25%%)\n", mode);
+                return 1;
+            }
+        } else if (strncmp(argv[a], "--page-size=", 12) == 0) {
+            g_pageSize = parseMemorySize(argv[a] + 12);
+            if (pageSizeShift(g_pageSize) < 0) {
+                fprintf(stderr, "tamanho de página inválido: %s (use potência de 2 a partir de 4KB, ex. 64KB, 2MB ou 1GB)\n", argv[a] + 12);
+                return 1;
+            }
+        } else if (strncmp(argv[a], "--huge=", 7) == 0) {
+            // "2MB" ou "2MB,25%": tamanho da pag enorme e qto da memoria fica reservado p elas
+            char size[32];
+            size_t len = strcspn(argv[a] + 7, ",");
+            snprintf(size, sizeof(size), "%.*s", (int)len, argv[a] + 7);
+            hugeSize = parseMemorySize(size);
+            if (argv[a][7 + len] == ',') {
+                char* end;
+                hugeShare = strtod(argv[a] + 8 + len, &end) / 100.0;
+                if (*end == '%') end++;
+                if (*end != '\0') hugeShare = -1;
+            }
+            if (pageSizeShift(hugeSize) < 0 || hugeShare <= 0 || hugeShare >= 1) {
+                fprintf(stderr, "pags enormes inválidas: %s (use ex. 2MB ou 2MB,25%%)\n", argv[a] + 7);
+                return 1;
+            }
+        } else if (strncmp(argv[a], "--checkpoint=", 13) == 0) {
+            checkpointPath = argv[a] + 13;
+            char* comma = strchr(checkpointPath, ',');
+            if (comma) {
+                *comma = '\0';
+                checkpointInterval = atoi(comma + 1);
+            }
+            if (*checkpointPath == '\0' || checkpointInterval < 1) {
+                fprintf(stderr, "checkpoint inválido: %s (use <arquivo> ou <arquivo>,<acessos>)\n", argv[a] + 13);
+                return 1;
+            }
+        } else if (strcmp(argv[a], "--resume") == 0) {
+            resume = 1;
+        } else if (strncmp(argv[a], "--resume=", 9) == 0) {
+            resume = 1;
+            resumePath = argv[a] + 9; // outro checkpoint: continua dele e grava os novos no --checkpoint
+        } else if (strncmp(argv[a], "--tlb=", 6) == 0) {
+            int levels = tlbConfig.levels;
+            if (parseTlbConfig(argv[a] + 6, &tlbConfig) != 0) {
+                fprintf(stderr, "TLB inválida: %s (use ex. 64, 64x4 ou 64x4,fifo; conjuntos em potência de 2)\n", argv[a] + 6);
+                return 1;
+            }
+            tlbConfig.levels = levels;
+        } else if (strncmp(argv[a], "--levels=", 9) == 0) {
+            tlbConfig.levels = atoi(argv[a] + 9);
+            if (tlbConfig.levels < 2 || tlbConfig.levels > MAX_PAGE_TABLE_LEVELS) {
+                fprintf(stderr, "qtde de níveis inválida: %s (use 2, 3 ou 4)\n", argv[a] + 9);
+                return 1;
+            }
+        } else if (strncmp(argv[a], "--ws=", 5) == 0) {
+            wsPath = argv[a] + 5;
+            char* comma = strchr(wsPath, ',');
+            if (comma) {
+                *comma = '\0';
+                wsPoints = atoi(comma + 1);
+            }
+            if (*wsPath == '\0' || wsPoints < 1) {
+                fprintf(stderr, "--ws inválido: %s (use <saida.csv> ou <saida.csv>,<pontos>)\n", argv[a] + 5);
+                return 1;
+            }
+        } else if (strncmp(argv[a], "--tau=", 6) == 0) {
+            // janelas em acessos, ex. 1000,10000,100000
+            char* p = argv[a] + 6;
+            numTaus = 0;
+            while (numTaus < MAX_WS_WINDOWS) {
+                char* end;
+                long tau = strtol(p, &end, 10);
+                if (end == p || tau < 1 || tau > INT_MAX) break;
+                taus[numTaus++] = (int)tau;
+                if (*end == '\0') {
+                    p = end;
+                    break;
+                }
+                if (*end != ',') break;
+                p = end + 1;
+            }
+            tauSet = 1;
+            if (numTaus == 0 || *p != '\0') {
+                fprintf(stderr, "lista de taus inválida: %s (use até %d janelas em acessos, ex. 1000,10000,100000)\n", argv[a] + 6, MAX_WS_WINDOWS);
+                return 1;
+            }
+        } else if (strncmp(argv[a], "--mrc=", 6) == 0) {
+            mrcPath = argv[a] + 6;
+        } else if (strncmp(argv[a], "--sample=", 9) == 0) {
+            // aceita fração (0.01) ou porcentagem (1%)
+            char* end;
+            sampleRate = strtod(argv[a] + 9, &end);
+            if (*end == '%') {
+                sampleRate /= 100.0;
+                end++;
+            }
+            if (*end != '\0' || sampleRate <= 0 || sampleRate > 1) {
+                fprintf(stderr, "taxa de amostragem inválida: %s (use ex. 0.01 ou 1%%)\n", argv[a] + 9);
+                return 1;
+            }
+        } else if (strncmp(argv[a], "--sizes=", 8) == 0) {
+            sizeList = argv[a] + 8;
+        } else if (strncmp(argv[a], "--threads=", 10) == 0) {
+            numThreads = atoi(argv[a] + 10);
+            if (numThreads < 1) {
+                fprintf(stderr, "qtde de threads inválida: %s\n", argv[a] + 10);
+                return 1;
+            }
+        } else if (strncmp(argv[a], "--policy=", 9) == 0) {
+            numPolicies = parsePolicyList(argv[a] + 9, policies, MAX_POLICIES);
+            if (numPolicies < 0) {
+                fprintf(stderr, "lista de políticas inválida: %s (use otimo,fifo,lru,clock,lfu,arc,2q ou all)\n", argv[a] + 9);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "opção desconhecida: %s\n", argv[a]);
+            return 1;
+        }
+    }
 
-    // ativa logs mais detalhados
-    if (argc > 3 && (strcmp(argv[3], "--verbose") == 0 || strcmp(argv[3], "-v") == 0)) {
-        g_verbose = 1;
-        printf("logs em tempo real executando.\n");
+    // no streaming o otimo roda fora da memoria (arquivos temporarios), mas a curva exata nao
+    if (streaming && mrcPath && sampleRate >= 1.0) {
+        fprintf(stderr, "a curva exata precisa do trace inteiro; em streaming use a aproximada (--sample=<taxa>).\n");
+        return 1;
+    }
+    if (multiprog >= 0 && (streaming || mrcPath || sizeList)) {
+        fprintf(stderr, "--multiprog precisa do trace inteiro na memória e não combina com --stream, --mrc ou --sizes.\n");
+        return 1;
+    }
+    if (tlbConfig.entries > 0 && (streaming || mrcPath || multiprog >= 0)) {
+        fprintf(stderr, "--tlb roda junto com a simulação normal e não combina com --stream, --mrc ou --multiprog.\n");
+        return 1;
+    }
+    // nos formatos de tracer a pag ja sai do endereço no tamanho simulado, entao o --page-size nao precisa do trace inteiro
+    if ((hugeSize > 0 || (g_pageSize != PAGE_SIZE_BYTES && g_traceFormat == TRACE_TEXT)) && streaming) {
+        fprintf(stderr, "--page-size e --huge precisam do trace inteiro na memória e não combinam com --stream.\n");
+        return 1;
+    }
+    if (g_traceFormat != TRACE_TEXT && (tlbConfig.entries > 0 || hugeSize > 0)) {
+        fprintf(stderr, "--tlb e --huge usam o prefixo e o número dos ids do formato padrão e não combinam com --format=lackey|perf.\n");
+        return 1;
+    }
+    if (reportSet && !streaming) {
+        fprintf(stderr, "--report-every vale só em streaming (--stream ou trace pela entrada padrão).\n");
+        return 1;
+    }
+    if (hugeSize > 0 && (mrcPath || multiprog >= 0 || tlbConfig.entries > 0 || sizeList)) {
+        fprintf(stderr, "--huge não combina com --mrc, --multiprog, --tlb ou --sizes.\n");
+        return 1;
+    }
+    if (resume && !checkpointPath) {
+        if (!resumePath) {
+            fprintf(stderr, "--resume precisa do --checkpoint=<arq> da execução original.\n");
+            return 1;
+        }
+        checkpointPath = resumePath;
+    }
+    if (resume && !resumePath) resumePath = checkpointPath;
+    if (checkpointPath && (streaming || mrcPath || multiprog >= 0 || hugeSize > 0)) {
+        fprintf(stderr, "--checkpoint vale para a simulação normal e não combina com --stream, --mrc, --multiprog ou --huge.\n");
+        return 1;
+    }
+    if (split >= 0 && (streaming || mrcPath || multiprog >= 0 || hugeSize > 0 || sizeList || tlbConfig.entries > 0 || checkpointPath || topK > 0)) {
+        fprintf(stderr, "--split precisa do trace inteiro na memória e não combina com --stream, --mrc, --multiprog, --huge, --sizes, --tlb, --checkpoint ou --top.\n");
+        return 1;
+    }
+    if (wsPath && (streaming || mrcPath || multiprog >= 0 || hugeSize > 0 || split >= 0 || sizeList || tlbConfig.entries > 0 || checkpointPath || topK > 0)) {
+        fprintf(stderr, "--ws precisa do trace inteiro na memória e não combina com --stream, --mrc, --multiprog, --huge, --split, --sizes, --tlb, --checkpoint ou --top.\n");
+        return 1;
+    }
+    if (topK > 0 && (mrcPath || multiprog >= 0 || hugeSize > 0)) {
+        fprintf(stderr, "--top vale para a simulação normal e não combina com --mrc, --multiprog ou --huge.\n");
+        return 1;
+    }
+    if (topCounters > 0 && checkpointPath) {
+        fprintf(stderr, "o --top aproximado não vai para o checkpoint; use o exato (--top=<K>) com --checkpoint.\n");
+        return 1;
+    }
+    if (tauSet && !wsPath) {
+        fprintf(stderr, "--tau só vale junto com --ws.\n");
+        return 1;
+    }
+    if (listLoads && (topK > 0 || mrcPath || multiprog >= 0 || hugeSize > 0 || split >= 0 || wsPath)) {
+        fprintf(stderr, "--loads vale para a simulação normal e não combina com --top, --mrc, --multiprog, --huge, --split ou --ws.\n");
+        return 1;
+    }
+    if (topPath && topK == 0) {
+        fprintf(stderr, "--top-out só vale junto com --top.\n");
+        return 1;
+    }
+    if (sampleRate < 1.0 && !mrcPath) {
+        fprintf(stderr, "--sample só vale junto com --mrc.\n");
+        return 1;
     }
 
     //parsea o tamanho da memória física
     long long memBytes = parseMemorySize(mem_size_str);
-    if (memBytes < PAGE_SIZE_BYTES) {
+    if (memBytes < g_pageSize) {
         fprintf(stderr, "tamanho de memória física inválido: %s\n", mem_size_str);
         return 1;
     }
 
     // calcula quantas pag cabe na memoria fisica
-    int numPages = memBytes / PAGE_SIZE_BYTES;
+    int numPages = memBytes / g_pageSize;
 
-    if (memBytes <= DIDATIC_MODE_ACTIVATOR) {
+    if (memBytes <= DIDATIC_MODE_ACTIVATOR && !mrcPath && !wsPath && multiprog < 0 && split < 0) {
         g_didaticMode = 1;
         printf("modo didático true para memória de %s.\n", mem_size_str);
 
@@ -49,185 +398,312 @@ int main(int argc, char *argv[]) {
     }
 
 
-    //inicio da contagem de acessos e registro de pags
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        perror("[ERRO] ao abrir o arquivo.");
+    // thread de logs das faltas (a curva nao faz logs)
+    if (g_verbose && !mrcPath && eventLogStart(logPath) != 0) {
+        perror("[ERRO] ao criar o log");
         return 1;
     }
 
     // inicia a tabela hash para contar páginas distintas
     hashInit();
 
-    // cria array q armazena sequencia de acessos de pag
-    PageAccess* tempAccessSequence = malloc(100000 * sizeof(PageAccess)); 
-    int capacity = 100000;
-    int numAccesses = 0;
-    char line[256];
-
-    // le o arq e extrai o id das pag
-    while (fgets(line, sizeof(line), file)) {
-        char buffer[MAX_PAGE_ID_LEN];
-        if (sscanf(line, "%*d %s", buffer) == 1 || sscanf(line, "%s", buffer) == 1) {
-            if (strcmp(buffer, "...") == 0) continue;
-            
-            
-            if (numAccesses >= capacity) {
-                capacity *= 2; // se precisar
-                tempAccessSequence = realloc(tempAccessSequence, capacity * sizeof(PageAccess));
-            }
-            // salva o id da pag no buffer 
-            strcpy(tempAccessSequence[numAccesses].page_id, buffer);
-            registerPage(buffer);
-            numAccesses++;
-        }
-    }
-    fclose(file);
-    
-     // ajusta o tam do array pra quantidade exata de acessos
-    PageAccess* accessSequence = realloc(tempAccessSequence, numAccesses * sizeof(PageAccess));
-    
-    // SIMULAÇÃO FIFO
-    printf("\nexecutando o fifo...\n");
-
-    int fifoFaults = 0;
-    
-    char **fifoFrames = (char**)malloc(numPages * sizeof(char*));
-    for(int i = 0; i < numPages; i++) fifoFrames[i] = NULL;
-
-    int fifoPointer = 0; // aponta p qual quadro vai ser substituido quando tiver page fault
-
-    PresenceNode* fifoPresenceMap[HASH_TABLE_SIZE] = {NULL}; // tabela hash q armazena as pag da mem fisica
-
-    // processa a sequencia de acessos 
-    for (int i = 0; i < numAccesses; i++) {
-        char* currentPageId = accessSequence[i].page_id;
-
-        if (i > 0 && i % LOG_INTERVAL == 0) {
-            printf("[FIFO] processando acesso %d...\n", i);
+    //inicio da contagem de acessos e registro de pags (no streaming a leitura acontece junto com as simulações)
+    double wallStart = wallClock();
+    double cpuStart = cpuClock();
+    Trace trace = { NULL, 0, NULL, NULL, 0, NULL };
+    if (!streaming) {
+        if (loadTrace(filename, &trace, multiprog >= 0) != 0) {
+            perror("[ERRO] ao abrir o arquivo.");
+            return 1;
         }
-
-        //usa a posicao do hash para verificar se a pag ta na mem
-        unsigned int hash_idx = presenceHash(currentPageId);
-        PresenceNode* p_node = fifoPresenceMap[hash_idx]; // verifica se a pag ta na memoria fisica
-
-        int pageFound = 0;
-
-        while(p_node) {
-            if(strcmp(p_node->page_id, currentPageId) == 0) {
-                pageFound = 1;
-                break;
-            }
-            p_node = p_node->next;
+        statsRecord("carregamento", wallClock() - wallStart, cpuClock() - cpuStart, trace.numAccesses, -1, 0);
+
+        // pag maior q a do trace: junta as pags uma vez aqui e o resto nem fica sabendo
+        if (g_pageSize != PAGE_SIZE_BYTES && g_traceFormat == TRACE_TEXT) {
+            wallStart = wallClock();
+            cpuStart = cpuClock();
+            applyPageSize(&trace, pageSizeShift(g_pageSize));
+            statsRecord("tamanho da página", wallClock() - wallStart, cpuClock() - cpuStart, trace.numAccesses, -1, 0);
         }
+    }
+    PageAccess* accessSequence = trace.accesses;
+    int numAccesses = trace.numAccesses;
+    long long totalAccesses = numAccesses;
+
+    // MODO MULTIPROGRAMAÇÃO: partições por processo x pool global, sem a simulação normal nem pergunta final
+    if (multiprog >= 0) {
+        wallStart = wallClock();
+        cpuStart = cpuClock();
+        int result = runMultiprogramming(&trace, policies, numPolicies, numPages, multiprog, numThreads);
+        eventLogStop();
+        statsRecord("multiprogramação (total)", wallClock() - wallStart, cpuClock() - cpuStart, numAccesses, -1, 0);
+        if (result == 0 && g_stats) printStats();
+
+        freeTrace(&trace);
+        cleanHashTable();
+        return (result == 0) ? 0 : 1;
+    }
 
-        if (!pageFound) { // page fault
-            fifoFaults++;
-            incrementLoadCount(currentPageId, "fifo");
-
-            char* victimPageId = NULL;
+    // MODO POOLS I/D: pool unico x pools de instruções e dados separados (fixos ou adaptativos)
+    if (split >= 0) {
+        wallStart = wallClock();
+        cpuStart = cpuClock();
+        int result = runSplitPools(&trace, policies, numPolicies, numPages, splitShare, split, numThreads);
+        eventLogStop();
+        statsRecord("pools I/D (total)", wallClock() - wallStart, cpuClock() - cpuStart, numAccesses, -1, 0);
+        if (result == 0 && g_stats) printStats();
+
+        freeTrace(&trace);
+        cleanHashTable();
+        return (result == 0) ? 0 : 1;
+    }
 
-            if (fifoFrames[fifoPointer]) {
-                victimPageId = strdup(fifoFrames[fifoPointer]);
-                
-                unsigned int victimHashIndex = presenceHash(victimPageId);
-                PresenceNode* curr = fifoPresenceMap[victimHashIndex];
+    // MODO PAGS ENORMES: so pag base x pool base + pool de pags enormes
+    if (hugeSize > 0) {
+        wallStart = wallClock();
+        cpuStart = cpuClock();
+        int result = runHugePages(&trace, policies, numPolicies, memBytes, hugeSize, hugeShare, numThreads);
+        eventLogStop();
+        statsRecord("pags enormes (total)", wallClock() - wallStart, cpuClock() - cpuStart, numAccesses, -1, 0);
+        if (result == 0 && g_stats) printStats();
+
+        freeTrace(&trace);
+        cleanHashTable();
+        return (result == 0) ? 0 : 1;
+    }
 
-                PresenceNode* prev = NULL;
+    // MODO WORKING SET: W(t, tau) e PFF numa passada, com serie temporal em csv
+    if (wsPath) {
+        wallStart = wallClock();
+        cpuStart = cpuClock();
+        int result = runWorkingSetAnalysis(accessSequence, numAccesses, taus, numTaus, numPages, wsPoints, wsPath);
+        eventLogStop();
+        statsRecord("working set e pff", wallClock() - wallStart, cpuClock() - cpuStart, numAccesses, -1, 0);
+        if (result == 0 && g_stats) printStats();
+
+        freeTrace(&trace);
+        cleanHashTable();
+        return (result == 0) ? 0 : 1;
+    }
 
-                while(curr) {
-                    if(strcmp(curr->page_id, victimPageId) == 0) {
-                        if(prev) prev->next = curr->next;
-                        else fifoPresenceMap[victimHashIndex] = curr->next;
-                        free(curr);
-                        break;
-                    }
-                    prev = curr;
-                    curr = curr->next;
-                }
+    // MODO CURVA: todos os tamanhos de uma vez, sem simulação individual nem pergunta final
+    if (mrcPath) {
+        int* frameCounts = NULL;
+        int numSizes;
+        if (sizeList) {
+            numSizes = parseFrameList(sizeList, &frameCounts);
+            if (numSizes < 0) {
+                fprintf(stderr, "lista de tamanhos inválida: %s\n", sizeList);
+                return 1;
             }
-            int slotIndex = fifoPointer; // salva o quadro q foi substituido
+        } else {
+            // sem lista: todo tamanho de 1 frame ate a memoria informada
+            numSizes = numPages;
+            frameCounts = (int*)malloc(numSizes * sizeof(int));
+            for (int i = 0; i < numSizes; i++) frameCounts[i] = i + 1;
+        }
 
-            if (g_verbose) {
-                char* old_page = victimPageId ? victimPageId : "empty";
-                printf("[FIFO] page fault #%d (acesso #%d): página '%s' não encontrada, substituindo '%s'.\n",
-                       fifoFaults, i + 1, currentPageId, old_page);
+        wallStart = wallClock();
+        cpuStart = cpuClock();
+        if (streaming) {
+            if (runSampledCurve(filename, frameCounts, numSizes, sampleRate, mrcPath) != 0) {
+                perror("[ERRO] ao ler o arquivo.");
+                return 1;
             }
+        } else {
+            runMissRatioCurve(accessSequence, numAccesses, frameCounts, numSizes, mrcPath, sampleRate);
+        }
+        statsRecord("curva de faltas", wallClock() - wallStart, cpuClock() - cpuStart, numAccesses, -1, 0);
+        if (g_stats) printStats();
 
-            free(fifoFrames[fifoPointer]);
-
-            //coloca nova pag no quadro 
-            fifoFrames[fifoPointer] = strdup(currentPageId);
+        free(frameCounts);
+        freeTrace(&trace);
+        cleanHashTable();
+        return 0;
+    }
+    
+    // configurações: a memoria principal + os tamanhos extras do --sizes
+    int* extraFrames = NULL;
+    int numExtra = 0;
+    if (sizeList) {
+        numExtra = parseFrameList(sizeList, &extraFrames);
+        if (numExtra < 0) {
+            fprintf(stderr, "lista de tamanhos inválida: %s\n", sizeList);
+            return 1;
+        }
+    }
 
-            // adiciona a nova pag na tabela de presença
-            PresenceNode* new_p_node = malloc(sizeof(PresenceNode));
-            strcpy(new_p_node->page_id, currentPageId);
-            new_p_node->next = fifoPresenceMap[hash_idx];
-            fifoPresenceMap[hash_idx] = new_p_node;
+    int numConfigs = 1;
+    int* configFrames = (int*)malloc((numExtra + 1) * sizeof(int));
+    configFrames[0] = numPages;
+    for (int c = 0; c < numExtra; c++) {
+        if (extraFrames[c] != numPages) configFrames[numConfigs++] = extraFrames[c];
+    }
+    free(extraFrames);
+
+    // logs em texto precisam sair na ordem, entao rodam numa thread so (no --log cada evento diz de qual simulação eh)
+    if (g_verbose && !logPath) numThreads = 1;
+
+    // so o otimo precisa do pre processamento (compartilhado entre os jobs)
+    int* nextUse = NULL;
+    const ReplacementPolicy* optimal = NULL;
+    for (int k = 0; k < numPolicies; k++) {
+        if (policies[k]->needsFuture && !nextUse && !streaming) {
+            wallStart = wallClock();
+            cpuStart = cpuClock();
+            if (resumePath) nextUse = loadCheckpointNextUse(resumePath, numAccesses); // pula o pre processamento
+            if (!nextUse) nextUse = preprocessOptimal(accessSequence, numAccesses);
+            statsRecord("pre processamento", wallClock() - wallStart, cpuClock() - cpuStart, numAccesses, -1, 0);
+        }
+        if (policies[k] == &optimalPolicy) optimal = policies[k];
+    }
 
-            if (g_didaticMode && g_verbose) {
-                displayFrameState("fifo", numPages, fifoFrames, currentPageId, victimPageId, slotIndex);
-            }
+    // SIMULAÇÕES: um job por politica e tamanho
+    int numJobs = numConfigs * numPolicies;
+    SimJob* jobs = (SimJob*)calloc(numJobs, sizeof(SimJob));
+    for (int c = 0; c < numConfigs; c++) {
+        for (int k = 0; k < numPolicies; k++) {
+            SimJob* job = &jobs[c * numPolicies + k];
+            job->policy = policies[k];
+            job->numFrames = configFrames[c];
+            job->primary = (c == 0);
+            // no --top aproximado a config principal conta as cargas em memoria fixa, sem vetor por pag
+            if (c == 0 && topCounters > 0) job->hitters = heavyHittersCreate(topCounters);
+            else if (c == 0) job->loads = (int*)calloc(g_pageCount > 0 ? g_pageCount : 1, sizeof(int));
+        }
+    }
 
-            free(victimPageId);
-            fifoPointer = (fifoPointer + 1) % numPages;
+    if (streaming) {
+        wallStart = wallClock();
+        cpuStart = cpuClock();
+        totalAccesses = runStreamJobs(filename, jobs, numJobs, reportEvery, reportSeconds);
+        if (totalAccesses < 0) {
+            perror("[ERRO] ao ler o arquivo.");
+            return 1;
         }
+        statsRecord("streaming (total)", wallClock() - wallStart, cpuClock() - cpuStart, totalAccesses, -1, 0);
+    } else if (checkpointPath) {
+        if (runCheckpointedJobs(jobs, numJobs, accessSequence, nextUse, numAccesses, numThreads, checkpointPath, resumePath,
+                                checkpointInterval) != 0) {
+            return 1;
+        }
+    } else {
+        runJobs(jobs, numJobs, accessSequence, nextUse, numAccesses, numThreads);
     }
 
-    // SIMULAÇÃO ÓTIMO
-    printf("\nexecutando o ótimo...\n");
-    preprocessOptimal(accessSequence, numAccesses); // pre processamento
-    int optimalFaults = runOptimalSimulation(accessSequence, numAccesses, numPages);
+    // tradução: mesma sequencia, independente das politicas
+    TlbResult tlbResult;
+    if (tlbConfig.entries > 0) {
+        wallStart = wallClock();
+        cpuStart = cpuClock();
+        runTlbSimulation(accessSequence, numAccesses, &tlbConfig, &tlbResult);
+        statsRecord("tlb + page walk", wallClock() - wallStart, cpuClock() - cpuStart, numAccesses, -1, 0);
+    }
 
+    // uma fase por job (cpu eh o da thread q rodou o job)
+    for (int j = 0; j < numJobs; j++) {
+        char phaseName[48];
+        snprintf(phaseName, sizeof(phaseName), "%s %d frames", jobs[j].policy->name, jobs[j].numFrames);
+        statsRecord(phaseName, jobs[j].stats.wallSeconds, jobs[j].stats.cpuSeconds, totalAccesses, jobs[j].faults,
+                    jobs[j].stats.scanSteps);
+    }
 
-    // RELATÓRIO FINAL
-    printf("\nRELATÓRIO:\n");
+    long long optimalFaults = 0;
+    for (int k = 0; k < numPolicies; k++) {
+        if (policies[k] == optimal) optimalFaults = jobs[k].faults;
+    }
 
-    // comparacao dos algoritmos
-    double efficiency = (fifoFaults > 0) ? ((double)optimalFaults / fifoFaults) * 100.0 : 0.0;
 
-    if (fifoFaults > 0) {
-       efficiency = (1.0 - (double)(fifoFaults - optimalFaults) / fifoFaults) * 100.0;
-    } else {
-       efficiency = 100.0;
-    }
+    // o q falta dos logs sai antes do relatorio
+    eventLogStop();
+    if (logPath) printf("\nlog das faltas gravado em %s (veja com %s --decode %s).\n", logPath, argv[0], logPath);
 
+    // RELATÓRIO FINAL
+    printf("\nRELATÓRIO:\n");
 
-    printf("a memória física comporta %d páginas.\n", numPages);
+    printf("a memória física comporta %d páginas", numPages);
+    if (g_pageSize != PAGE_SIZE_BYTES) printf(" de %lld bytes", g_pageSize);
+    printf(".\n");
+    if (streaming) printf("foram lidos %lld acessos em streaming.\n", totalAccesses);
     printf("há %d páginas distintas no arquivo.\n", g_pageCount);
     
     long long tableSize = (long long)g_pageCount * 8; // estimativa de 8 bytes por entrada
     
     printf("estimativa do tamanho da tabela de páginas (1 nível): %lld bytes (%.2f KB).\n",
            tableSize, (double)tableSize / 1024.0);
+    if (tlbConfig.entries > 0) printTlbReport(&tlbConfig, &tlbResult);
+
+    // comparacao de cada politica com o otimo (quando ele rodou)
+    for (int k = 0; k < numPolicies; k++) {
+        long long faults = jobs[k].faults;
+        if (!optimal || policies[k] == optimal) {
+            printf("com o algoritmo %s ocorrem %lld faltas de página.\n", policies[k]->label, faults);
+            continue;
+        }
+        double efficiency = (faults > 0) ? (1.0 - (double)(faults - optimalFaults) / faults) * 100.0 : 100.0;
+        printf("com o algoritmo %s ocorrem %lld faltas de página,\n", policies[k]->label, faults);
+        printf("desempenho do %s em relação ao OTIMO: %.2f%%\n", policies[k]->label, efficiency);
+    }
 
-    printf("com o algoritmo ÓTIMO ocorrem %d faltas de página.\n", optimalFaults);
-    printf("com o algoritmo FIFO ocorrem %d faltas de página,\n", fifoFaults);
-    printf("desempenho do FIFO em relação ao OTIMO: %.2f%%\n", efficiency);
+    if (numConfigs > 1) {
+        printf("\n%-12s %-10s", "memória", "frames");
+        for (int k = 0; k < numPolicies; k++) printf(" %-12s", policies[k]->name);
+        printf("\n");
+        for (int k = 0; k <= numPolicies + 1; k++) printf("-------------");
+        printf("\n");
+        for (int c = 0; c < numConfigs; c++) {
+            printf("%-12lld %-10d", (long long)configFrames[c] * g_pageSize, configFrames[c]);
+            for (int k = 0; k < numPolicies; k++) printf(" %-12lld", jobs[c * numPolicies + k].faults);
+            printf("\n");
+        }
+    }
+
+    if (g_stats) printStats();
     
-    printf("\ndeseja listar o número de carregamentos (s/n)? ");
-    char choice;
-    scanf(" %c", &choice);
+    // --top: so o ranking (csv/json opcional) no lugar da listagem de todas as pags
+    if (topK > 0) {
+        const char* names[MAX_POLICIES];
+        int* loads[MAX_POLICIES];
+        HeavyHitters* hitters[MAX_POLICIES];
+        int optimalColumn = -1;
+        for (int k = 0; k < numPolicies; k++) {
+            names[k] = policies[k]->name;
+            loads[k] = jobs[k].loads;
+            hitters[k] = jobs[k].hitters;
+            if (policies[k] == optimal) optimalColumn = k;
+        }
+        if (runTopReport(names, loads, hitters, numPolicies, optimalColumn, topK, g_pageCount, topPath) != 0) {
+            perror("[ERRO] ao gravar o ranking");
+        }
+    }
+
+    // so pergunta com alguem no terminal (lendo o trace do stdin, num pipe ou em lote nao tem a quem perguntar)
+    char choice = listLoads ? 's' : 'n';
+    if (!listLoads && strcmp(filename, "-") != 0 && topK == 0 && isatty(STDIN_FILENO)) {
+        printf("\ndeseja listar o número de carregamentos (s/n)? ");
+        scanf(" %c", &choice);
+    }
     
     if (choice == 's' || choice == 'S') {
-        loadSummary();
+        const char* names[MAX_POLICIES];
+        int* loads[MAX_POLICIES];
+        for (int k = 0; k < numPolicies; k++) {
+            names[k] = policies[k]->name;
+            loads[k] = jobs[k].loads;
+        }
+        loadSummary(names, loads, numPolicies);
     }
 
-    free(accessSequence);
+    freeTrace(&trace);
+    free(nextUse);
     cleanHashTable();
-    
-    for (int i = 0; i < numPages; i++) free(fifoFrames[i]);
-    free(fifoFrames);
-    
-    // limpa a tabela de presença do fifo
-    for(int i = 0; i < HASH_TABLE_SIZE; ++i) {
-        PresenceNode* curr = fifoPresenceMap[i];
-        while(curr) {
-            PresenceNode* temp = curr;
-            curr = curr->next;
-            free(temp);
-        }
+
+    for (int k = 0; k < numJobs; k++) {
+        free(jobs[k].loads);
+        heavyHittersFree(jobs[k].hitters);
     }
+    free(jobs);
+    free(configFrames);
 
     printf("\nterminou!\n");
     return 0;
@@ -0,0 +1,213 @@
+#include "simulator.h"
+#include "memsim.h"
+#include <errno.h>
+
+// libmemsim: contexto com tabela de pags e simulações proprias (sem registerPage, g_pageCount, --stats nem logs)
+// as politicas online andam a cada acesso; as offline (otimo) precisam do futuro, entao o contexto guarda
+// a sequencia e roda elas inteiras na consulta, so qdo entrou acesso novo desde a ultima
+
+// os formatos do memsim.h sao os mesmos do TraceParser
+_Static_assert((int)MEMSIM_TRACE_TEXT == TRACE_TEXT && (int)MEMSIM_TRACE_LACKEY == TRACE_LACKEY &&
+                   (int)MEMSIM_TRACE_PERF == TRACE_PERF,
+               "formatos do memsim.h fora de ordem");
+
+struct MemSim {
+    PageTable pages;
+    Arena arena;
+    const ReplacementPolicy* policies[MAX_POLICIES];
+    Simulation sims[MAX_POLICIES]; // so as online sao usadas
+    long long offlineFaults[MAX_POLICIES];
+    long long offlineAt[MAX_POLICIES]; // acessos qdo o offlineFaults foi calculado (-1 = nunca)
+    int numPolicies;
+    int numFrames;
+    int capacity;        // pags q as simulações online comportam (crescem com simGrow)
+    int hasOffline;
+    long long accesses;
+    PageAccess* history; // sequencia inteira, so qdo tem politica offline
+    int historyCapacity;
+};
+
+struct MemSimTrace {
+    Trace trace;
+    PageTable pages;
+    Arena arena;
+};
+
+MemSim* memsimCreate(const char* policies, int numFrames) {
+    if (!policies || numFrames < 1) return NULL;
+    MemSim* sim = (MemSim*)policyAlloc(1, sizeof(MemSim));
+    sim->numPolicies = parsePolicyList(policies, sim->policies, MAX_POLICIES);
+    if (sim->numPolicies < 0) {
+        free(sim);
+        return NULL;
+    }
+
+    pageTableInit(&sim->pages, &sim->arena);
+    sim->numFrames = numFrames;
+    sim->capacity = 1024;
+    for (int k = 0; k < sim->numPolicies; k++) {
+        sim->offlineAt[k] = -1;
+        if (sim->policies[k]->needsFuture) sim->hasOffline = 1;
+        else simInit(&sim->sims[k], sim->policies[k], numFrames, sim->capacity, NULL, 0);
+    }
+    return sim;
+}
+
+void memsimDestroy(MemSim* sim) {
+    if (!sim) return;
+    for (int k = 0; k < sim->numPolicies; k++) {
+        if (!sim->policies[k]->needsFuture) simFree(&sim->sims[k]);
+    }
+    pageTableFree(&sim->pages);
+    free(sim->history);
+    free(sim);
+}
+
+// prepara count acessos novos: cresce as simulações p as pags ja registradas e o historico; -1 = nao cabe
+static int reserve(MemSim* sim, int count) {
+    if (sim->pages.count > sim->capacity) {
+        while (sim->capacity < sim->pages.count) sim->capacity *= 2;
+        for (int k = 0; k < sim->numPolicies; k++) {
+            if (!sim->policies[k]->needsFuture) simGrow(&sim->sims[k], sim->capacity);
+        }
+    }
+    if (!sim->hasOffline) return 0;
+    if (sim->accesses + count > INT_MAX) return -1; // o otimo indexa a sequencia com int
+    if (sim->accesses + count > sim->historyCapacity) {
+        int capacity = sim->historyCapacity ? sim->historyCapacity : 65536;
+        while (capacity < sim->accesses + count) capacity = (capacity > INT_MAX / 2) ? INT_MAX : capacity * 2;
+        sim->history = (PageAccess*)policyRealloc(sim->history, sim->historyCapacity, capacity, sizeof(PageAccess));
+        sim->historyCapacity = capacity;
+    }
+    return 0;
+}
+
+// entrega os acessos ja traduzidos p indices densos do contexto
+static void feed(MemSim* sim, const uint32_t* pages, int count) {
+    for (int k = 0; k < sim->numPolicies; k++) {
+        if (sim->policies[k]->needsFuture) continue;
+        Simulation* s = &sim->sims[k];
+        for (int i = 0; i < count; i++) simAccess(s, pages[i], sim->accesses + i, 0);
+    }
+    if (sim->hasOffline) {
+        for (int i = 0; i < count; i++) sim->history[sim->accesses + i].page = pages[i];
+    }
+    sim->accesses += count;
+}
+
+int memsimAccess(MemSim* sim, const char* pageId) {
+    return memsimAccessBatch(sim, &pageId, 1);
+}
+
+int memsimAccessBatch(MemSim* sim, const char* const* pageIds, int count) {
+    if (count <= 0) return 0;
+    uint32_t pages[1024];
+    for (int done = 0; done < count;) {
+        int block = (count - done > 1024) ? 1024 : count - done;
+        for (int i = 0; i < block; i++) pages[i] = pageTableIntern(&sim->pages, pageIds[done + i]);
+        if (reserve(sim, block) != 0) return -1;
+        feed(sim, pages, block);
+        done += block;
+    }
+    return 0;
+}
+
+// as pags do trace sao traduzidas uma vez cada (nao por acesso) p os indices do contexto
+int memsimAccessTrace(MemSim* sim, const MemSimTrace* trace) {
+    const Trace* t = &trace->trace;
+    uint32_t* remap = (uint32_t*)policyAlloc(trace->pages.count, sizeof(uint32_t));
+    for (int p = 0; p < trace->pages.count; p++) remap[p] = pageTableIntern(&sim->pages, pageTableName(&trace->pages, p));
+    if (reserve(sim, t->numAccesses) != 0) {
+        free(remap);
+        return -1;
+    }
+
+    uint32_t pages[1024];
+    for (int done = 0; done < t->numAccesses;) {
+        int block = (t->numAccesses - done > 1024) ? 1024 : t->numAccesses - done;
+        for (int i = 0; i < block; i++) pages[i] = remap[t->accesses[done + i].page];
+        feed(sim, pages, block);
+        done += block;
+    }
+    free(remap);
+    return 0;
+}
+
+int memsimPolicyCount(const MemSim* sim) {
+    return sim->numPolicies;
+}
+
+const char* memsimPolicyName(const MemSim* sim, int policy) {
+    return (policy >= 0 && policy < sim->numPolicies) ? sim->policies[policy]->name : NULL;
+}
+
+long long memsimFaults(MemSim* sim, int policy) {
+    if (policy < 0 || policy >= sim->numPolicies) return -1;
+    if (!sim->policies[policy]->needsFuture) return sim->sims[policy].faults;
+
+    // offline: refaz sobre a sequencia toda se entrou acesso novo (o nextUse serve p todas as offline)
+    // (simRun direto e nao runPolicySimulation, q conversa com o log de eventos do programa)
+    if (sim->offlineAt[policy] != sim->accesses) {
+        int numAccesses = (int)sim->accesses;
+        int* nextUse = computeNextUse(sim->history, numAccesses, sim->pages.count);
+        for (int k = 0; k < sim->numPolicies; k++) {
+            if (!sim->policies[k]->needsFuture || sim->offlineAt[k] == sim->accesses) continue;
+            Simulation offline;
+            simInit(&offline, sim->policies[k], sim->numFrames, sim->pages.count, NULL, 0);
+            simRun(&offline, sim->history, nextUse, 0, numAccesses);
+            sim->offlineFaults[k] = offline.faults;
+            simFree(&offline);
+            sim->offlineAt[k] = sim->accesses;
+        }
+        free(nextUse);
+    }
+    return sim->offlineFaults[policy];
+}
+
+long long memsimAccessCount(const MemSim* sim) {
+    return sim->accesses;
+}
+
+int memsimPageCount(const MemSim* sim) {
+    return sim->pages.count;
+}
+
+MemSimTrace* memsimTraceLoad(const char* path) {
+    return memsimTraceLoadFormat(path, MEMSIM_TRACE_TEXT, PAGE_SIZE_BYTES);
+}
+
+MemSimTrace* memsimTraceLoadFormat(const char* path, int format, long long pageSize) {
+    // no texto os ids ja sao as pags (o --page-size do programa agrupa depois da carga, com a tabela global)
+    int pageShift = pageSizeShift(pageSize);
+    if (format < MEMSIM_TRACE_TEXT || format > MEMSIM_TRACE_PERF || pageShift < 0 ||
+        (format == MEMSIM_TRACE_TEXT && pageShift != 0)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    TraceParser parser;
+    traceParserInit(&parser, format, pageShift);
+
+    MemSimTrace* trace = (MemSimTrace*)policyAlloc(1, sizeof(MemSimTrace));
+    pageTableInit(&trace->pages, &trace->arena);
+    if (loadTraceInto(path, &trace->trace, 0, &trace->pages, &parser) != 0) {
+        pageTableFree(&trace->pages);
+        free(trace);
+        return NULL;
+    }
+    return trace;
+}
+
+void memsimTraceFree(MemSimTrace* trace) {
+    if (!trace) return;
+    freeTrace(&trace->trace);
+    pageTableFree(&trace->pages);
+    free(trace);
+}
+
+long long memsimTraceLength(const MemSimTrace* trace) {
+    return trace->trace.numAccesses;
+}
+
+int memsimTracePageCount(const MemSimTrace* trace) {
+    return trace->pages.count;
+}
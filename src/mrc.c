@@ -0,0 +1,411 @@
+#include "simulator.h"
+
+// curva de taxa de faltas (miss ratio curve) p varios tamanhos de memoria numa passada so
+// lru: distancia de pilha de mattson com arvore de fenwick, O(n log n)
+// otimo: algoritmo de pilha do otimo (prioridade = proximo uso), O(n * profundidade)
+// fifo nao eh algoritmo de pilha, entao simula cada tamanho separado
+// lru aproximado (SHARDS): a mesma distancia de pilha, mas so numa amostra das pags escolhida pelo hash do id
+
+// soma prefixada em [0, i] da arvore de fenwick
+static int fenwickSum(const int* tree, int i) {
+    int sum = 0;
+    for (i++; i > 0; i -= i & -i) sum += tree[i];
+    return sum;
+}
+
+static void fenwickAdd(int* tree, int size, int i, int delta) {
+    for (i++; i <= size; i += i & -i) tree[i] += delta;
+}
+
+// hitsAt[d] = acessos com distancia de pilha d (1..maxFrames); o resto vira falta em qualquer tamanho
+static void lruStackDistances(PageAccess* accessSequence, int numAccesses, int maxFrames, long long* hitsAt) {
+    int* tree = (int*)calloc(numAccesses + 1, sizeof(int)); // marca o ultimo acesso de cada pag
+    int* lastAccess = (int*)malloc((g_pageCount > 0 ? g_pageCount : 1) * sizeof(int));
+    if (!tree || !lastAccess) {
+        perror("falha ao alocar memoria para a pilha do lru");
+        exit(1);
+    }
+    for (int p = 0; p < g_pageCount; p++) lastAccess[p] = -1;
+
+    for (int i = 0; i < numAccesses; i++) {
+        uint32_t page = accessSequence[i].page;
+        int last = lastAccess[page];
+
+        if (last != -1) {
+            // paginas distintas acessadas depois do ultimo uso + ela mesma
+            int distance = fenwickSum(tree, i - 1) - fenwickSum(tree, last) + 1;
+            if (distance <= maxFrames) hitsAt[distance]++;
+            fenwickAdd(tree, numAccesses, last, -1);
+        }
+
+        fenwickAdd(tree, numAccesses, i, 1);
+        lastAccess[page] = i;
+    }
+
+    free(tree);
+    free(lastAccess);
+}
+
+// pilha do otimo truncada em maxFrames: o conteudo de uma memoria de c frames eh sempre o topo c da pilha
+static void optStackDistances(PageAccess* accessSequence, const int* nextUse, int numAccesses, int maxFrames, long long* hitsAt) {
+    uint32_t* stack = (uint32_t*)malloc(maxFrames * sizeof(uint32_t));
+    int* position = (int*)malloc((g_pageCount > 0 ? g_pageCount : 1) * sizeof(int)); // -1 = fora da pilha
+    int* priority = (int*)malloc((g_pageCount > 0 ? g_pageCount : 1) * sizeof(int)); // proximo uso de cada pag
+    if (!stack || !position || !priority) {
+        perror("falha ao alocar memoria para a pilha do otimo");
+        exit(1);
+    }
+    for (int p = 0; p < g_pageCount; p++) position[p] = -1;
+    int stackSize = 0;
+
+    for (int i = 0; i < numAccesses; i++) {
+        uint32_t page = accessSequence[i].page;
+        int depth = position[page];
+        priority[page] = nextUse[i];
+
+        if (depth != -1) hitsAt[depth + 1]++;
+        if (depth == 0) continue;
+
+        // a pag vai pro topo; em cada nivel fica quem vai ser usado antes e desce quem vai ser usado mais tarde
+        uint32_t carry = stack[0];
+        int limit = (depth != -1) ? depth : stackSize;
+        if (stackSize == 0) {
+            stack[stackSize++] = page;
+            position[page] = 0;
+            continue;
+        }
+        stack[0] = page;
+        position[page] = 0;
+
+        for (int j = 1; j < limit; j++) {
+            uint32_t resident = stack[j];
+            if (priority[resident] > priority[carry]) {
+                stack[j] = carry;
+                position[carry] = j;
+                carry = resident;
+            }
+        }
+
+        if (depth != -1) {
+            stack[depth] = carry;
+            position[carry] = depth;
+        } else if (stackSize < maxFrames) {
+            stack[stackSize] = carry;
+            position[carry] = stackSize++;
+        } else {
+            position[carry] = -1; // caiu pra fora de todas as memorias consideradas
+        }
+    }
+
+    free(stack);
+    free(position);
+    free(priority);
+}
+
+// AMOSTRAGEM ESPACIAL
+// a decisao depende so do id, entao uma pag amostrada tem todos os acessos amostrados
+// e a distancia de pilha na amostra estima distancia real * taxa
+
+uint64_t sampleThreshold(double rate) {
+    if (rate >= 1.0) return (uint64_t)UINT32_MAX + 1; // tudo
+    return (uint64_t)(rate * 4294967296.0);
+}
+
+int pageSampled(const char* page_id, uint64_t threshold) {
+    return threshold > UINT32_MAX || hashOptimize(page_id) < threshold;
+}
+
+void shardsInit(ShardsSampler* sampler, double rate, int maxFrames) {
+    memset(sampler, 0, sizeof(*sampler));
+    sampler->rate = rate;
+    sampler->maxFrames = maxFrames;
+    sampler->hitsAt = (long long*)policyAlloc(maxFrames + 1, sizeof(long long));
+    sampler->capacity = 1024;
+    sampler->tree = (int*)policyAlloc(sampler->capacity + 1, sizeof(int));
+    sampler->pageAt = (uint32_t*)policyAlloc(sampler->capacity, sizeof(uint32_t));
+}
+
+// posicoes cheias: descarta as q nao sao mais o ultimo acesso de nenhuma pag (mantendo a ordem)
+// e reconstroi a fenwick em O(n); o espaço fica proporcional as pags amostradas, nao ao trace
+static void shardsCompact(ShardsSampler* sampler) {
+    int live = 0;
+    for (int i = 0; i < sampler->used; i++) {
+        uint32_t page = sampler->pageAt[i];
+        if (page == PAGE_NONE) continue;
+        sampler->pageAt[live] = page;
+        sampler->lastPos[page] = live++;
+    }
+    sampler->used = live;
+
+    if (live * 2 > sampler->capacity) {
+        int capacity = sampler->capacity * 2;
+        sampler->pageAt = (uint32_t*)policyRealloc(sampler->pageAt, sampler->capacity, capacity, sizeof(uint32_t));
+        free(sampler->tree);
+        sampler->tree = (int*)policyAlloc(capacity + 1, sizeof(int));
+        sampler->capacity = capacity;
+    } else {
+        memset(sampler->tree, 0, (sampler->capacity + 1) * sizeof(int));
+    }
+
+    for (int i = 1; i <= live; i++) sampler->tree[i] = 1;
+    for (int i = 1; i <= sampler->capacity; i++) {
+        int parent = i + (i & -i);
+        if (parent <= sampler->capacity) sampler->tree[parent] += sampler->tree[i];
+    }
+}
+
+void shardsAccess(ShardsSampler* sampler, uint32_t page) {
+    if ((int)page >= sampler->lastCapacity) {
+        int capacity = (sampler->lastCapacity > 0) ? sampler->lastCapacity : 1024;
+        while (capacity <= (int)page) capacity *= 2;
+        sampler->lastPos = (int*)policyRealloc(sampler->lastPos, sampler->lastCapacity, capacity, sizeof(int));
+        for (int p = sampler->lastCapacity; p < capacity; p++) sampler->lastPos[p] = -1;
+        sampler->lastCapacity = capacity;
+    }
+    if (sampler->used == sampler->capacity) shardsCompact(sampler);
+
+    sampler->sampled++;
+    int last = sampler->lastPos[page];
+    int position = sampler->used++;
+
+    if (last != -1) {
+        int distance = fenwickSum(sampler->tree, position - 1) - fenwickSum(sampler->tree, last) + 1;
+        long long scaled = (long long)(distance / sampler->rate + 0.5);
+        if (scaled <= sampler->maxFrames) sampler->hitsAt[scaled > 0 ? scaled : 1]++;
+        fenwickAdd(sampler->tree, sampler->capacity, last, -1);
+        sampler->pageAt[last] = PAGE_NONE;
+    }
+
+    fenwickAdd(sampler->tree, sampler->capacity, position, 1);
+    sampler->pageAt[position] = page;
+    sampler->lastPos[page] = position;
+}
+
+// taxa de faltas estimada p numFrames (correção SHARDS-adj: normaliza pelo tamanho esperado da amostra,
+// taxa * acessos, e nao pelo sorteado, q varia com as pags quentes q cairam ou nao na amostra)
+double shardsMissRatio(const ShardsSampler* sampler, int numFrames) {
+    double expected = sampler->rate * sampler->accesses;
+    if (expected <= 0) return 0.0;
+    long long hits = 0;
+    for (int d = 1; d <= numFrames && d <= sampler->maxFrames; d++) hits += sampler->hitsAt[d];
+    double ratio = (sampler->sampled - hits) / expected;
+    return (ratio < 0) ? 0.0 : (ratio > 1) ? 1.0 : ratio;
+}
+
+void shardsFree(ShardsSampler* sampler) {
+    free(sampler->hitsAt);
+    free(sampler->tree);
+    free(sampler->pageAt);
+    free(sampler->lastPos);
+    memset(sampler, 0, sizeof(*sampler));
+}
+
+// fifo sem logs nem contadores por pag, so conta as faltas
+static long long fifoFaultsFor(PageAccess* accessSequence, int numAccesses, int numFrames, unsigned char* presence, uint32_t* frames) {
+    long long faults = 0;
+    int pointer = 0;
+    memset(presence, 0, g_pageCount);
+    for (int i = 0; i < numFrames; i++) frames[i] = PAGE_NONE;
+
+    for (int i = 0; i < numAccesses; i++) {
+        uint32_t page = accessSequence[i].page;
+        if (presence[page]) continue;
+
+        faults++;
+        if (frames[pointer] != PAGE_NONE) presence[frames[pointer]] = 0;
+        frames[pointer] = page;
+        presence[page] = 1;
+        pointer = (pointer + 1) % numFrames;
+    }
+    return faults;
+}
+
+// curva aproximada sobre o trace ja carregado (p comparar com a exata); o teste do hash eh feito uma vez por pag
+static void sampleLoadedTrace(ShardsSampler* sampler, PageAccess* accessSequence, int numAccesses) {
+    uint64_t threshold = sampleThreshold(sampler->rate);
+    unsigned char* sampled = (unsigned char*)policyAlloc(g_pageCount, sizeof(unsigned char));
+    for (int p = 0; p < g_pageCount; p++) sampled[p] = pageSampled(pageName(p), threshold);
+
+    for (int i = 0; i < numAccesses; i++) {
+        uint32_t page = accessSequence[i].page;
+        if (sampled[page]) shardsAccess(sampler, page);
+    }
+    sampler->accesses = numAccesses;
+    free(sampled);
+}
+
+// curva aproximada do lru contra a exata no mesmo trace: mede o erro e o tempo das duas
+// (so o lru, q eh o q a amostragem estima; sem o otimo e o fifo da p usar tamanhos grandes)
+static void compareSampledCurve(PageAccess* accessSequence, int numAccesses, const int* frameCounts, int numSizes,
+                                const char* outPath, double sampleRate) {
+    int maxFrames = frameCounts[numSizes - 1];
+    FILE* out = fopen(outPath, "w");
+    if (!out) {
+        perror("[ERRO] ao criar o arquivo da curva");
+        exit(1);
+    }
+
+    printf("[curva] calculando distancias de pilha do lru...\n");
+    double exactStart = wallClock();
+    long long* lruHits = (long long*)policyAlloc(maxFrames + 1, sizeof(long long));
+    lruStackDistances(accessSequence, numAccesses, maxFrames, lruHits);
+    double exactSeconds = wallClock() - exactStart;
+
+    printf("[curva] calculando o lru aproximado com %.4g%% das páginas...\n", sampleRate * 100.0);
+    double sampledStart = wallClock();
+    ShardsSampler sampler;
+    shardsInit(&sampler, sampleRate, maxFrames);
+    sampleLoadedTrace(&sampler, accessSequence, numAccesses);
+    double sampledSeconds = wallClock() - sampledStart;
+
+    fprintf(out, "frames,bytes,lru_faltas,lru_taxa,lru_aprox_taxa,lru_aprox_erro\n");
+    long long lruHitSum = 0;
+    int d = 1;
+    double total = (numAccesses > 0) ? (double)numAccesses : 1.0;
+    double maxError = 0, errorSum = 0;
+
+    for (int s = 0; s < numSizes; s++) {
+        int frameCount = frameCounts[s];
+        for (; d <= frameCount; d++) lruHitSum += lruHits[d];
+        long long lruFaults = numAccesses - lruHitSum;
+        double estimate = shardsMissRatio(&sampler, frameCount);
+        double error = estimate - lruFaults / total;
+
+        fprintf(out, "%d,%lld,%lld,%.6f,%.6f,%.6f\n", frameCount, (long long)frameCount * g_pageSize,
+                lruFaults, lruFaults / total, estimate, error);
+        if (error < 0) error = -error;
+        if (error > maxError) maxError = error;
+        errorSum += error;
+    }
+
+    fclose(out);
+    printf("[curva] %d tamanhos gravados em %s.\n", numSizes, outPath);
+    printf("[curva] lru aproximado: %lld de %d acessos amostrados, erro absoluto máximo %.4f e médio %.4f contra a curva exata.\n",
+           sampler.sampled, numAccesses, maxError, errorSum / numSizes);
+    printf("[curva] lru aproximado em %.3fs contra %.3fs da curva exata.\n", sampledSeconds, exactSeconds);
+    if (frameCounts[0] * sampleRate < 100) {
+        printf("[curva] aviso: com taxa %.4g a resolução é de ~%.0f frames; tamanhos menores que ~%.0f frames ficam imprecisos.\n",
+               sampleRate, 1.0 / sampleRate, 100.0 / sampleRate);
+    }
+
+    shardsFree(&sampler);
+    free(lruHits);
+}
+
+// gera o csv da curva p cada tamanho de frameCounts (ordenado crescente) e avisa anomalias de belady no fifo
+// sampleRate < 1 troca pela comparação da curva aproximada do lru com a exata
+void runMissRatioCurve(PageAccess* accessSequence, int numAccesses, const int* frameCounts, int numSizes, const char* outPath,
+                       double sampleRate) {
+    if (sampleRate < 1.0) {
+        compareSampledCurve(accessSequence, numAccesses, frameCounts, numSizes, outPath, sampleRate);
+        return;
+    }
+    int maxFrames = frameCounts[numSizes - 1];
+
+    FILE* out = fopen(outPath, "w");
+    if (!out) {
+        perror("[ERRO] ao criar o arquivo da curva");
+        exit(1);
+    }
+
+    long long* lruHits = (long long*)calloc(maxFrames + 1, sizeof(long long));
+    long long* optHits = (long long*)calloc(maxFrames + 1, sizeof(long long));
+    long long* fifoFaults = (long long*)malloc(numSizes * sizeof(long long));
+    unsigned char* presence = (unsigned char*)malloc(g_pageCount > 0 ? g_pageCount : 1);
+    uint32_t* frames = (uint32_t*)malloc(maxFrames * sizeof(uint32_t));
+    if (!lruHits || !optHits || !fifoFaults || !presence || !frames) {
+        perror("falha ao alocar memoria para a curva");
+        exit(1);
+    }
+
+    printf("[curva] calculando distancias de pilha do lru...\n");
+    lruStackDistances(accessSequence, numAccesses, maxFrames, lruHits);
+
+    printf("[curva] calculando pilha do otimo...\n");
+    int* nextUse = preprocessOptimal(accessSequence, numAccesses);
+    optStackDistances(accessSequence, nextUse, numAccesses, maxFrames, optHits);
+    free(nextUse);
+
+    printf("[curva] simulando o fifo em %d tamanhos...\n", numSizes);
+    for (int s = 0; s < numSizes; s++) {
+        fifoFaults[s] = fifoFaultsFor(accessSequence, numAccesses, frameCounts[s], presence, frames);
+    }
+
+    fprintf(out, "frames,bytes,lru_faltas,lru_taxa,otimo_faltas,otimo_taxa,fifo_faltas,fifo_taxa\n");
+
+    // faltas(c) = acessos - hits com distancia <= c, acumulando na ordem dos tamanhos
+    long long lruHitSum = 0, optHitSum = 0;
+    int d = 1;
+    int anomalies = 0;
+    double total = (numAccesses > 0) ? (double)numAccesses : 1.0;
+
+    for (int s = 0; s < numSizes; s++) {
+        int frameCount = frameCounts[s];
+        for (; d <= frameCount; d++) {
+            lruHitSum += lruHits[d];
+            optHitSum += optHits[d];
+        }
+        long long lruFaults = numAccesses - lruHitSum;
+        long long optFaults = numAccesses - optHitSum;
+
+        fprintf(out, "%d,%lld,%lld,%.6f,%lld,%.6f,%lld,%.6f\n", frameCount, (long long)frameCount * g_pageSize,
+                lruFaults, lruFaults / total, optFaults, optFaults / total, fifoFaults[s], fifoFaults[s] / total);
+
+        if (s > 0 && fifoFaults[s] > fifoFaults[s - 1]) {
+            anomalies++;
+            printf("[curva] anomalia de belady no fifo: %d frames -> %lld faltas, %d frames -> %lld faltas.\n",
+                   frameCounts[s - 1], fifoFaults[s - 1], frameCount, fifoFaults[s]);
+        }
+    }
+
+    fclose(out);
+    printf("[curva] %d tamanhos gravados em %s (%d anomalias de belady no fifo).\n", numSizes, outPath, anomalies);
+
+    free(lruHits);
+    free(optHits);
+    free(fifoFaults);
+    free(presence);
+    free(frames);
+}
+
+// MODO AMOSTRADO EM STREAMING: le o trace em blocos e so interna as pags da amostra,
+// entao tempo de simulação e memoria caem junto com a taxa (a leitura do arquivo continua inteira)
+int runSampledCurve(const char* filename, const int* frameCounts, int numSizes, double sampleRate, const char* outPath) {
+    TraceReader reader;
+    if (traceReaderOpen(&reader, filename, sampleRate) != 0) {
+        traceReaderClose(&reader);
+        return -1;
+    }
+    FILE* out = fopen(outPath, "w");
+    if (!out) {
+        perror("[ERRO] ao criar o arquivo da curva");
+        exit(1);
+    }
+
+    printf("[curva] calculando o lru aproximado em streaming com %.4g%% das páginas...\n", sampleRate * 100.0);
+    ShardsSampler sampler;
+    shardsInit(&sampler, sampleRate, frameCounts[numSizes - 1]);
+    PageAccess* chunk = (PageAccess*)policyAlloc(STREAM_CHUNK_ACCESSES, sizeof(PageAccess));
+    int count;
+    while ((count = traceReaderNext(&reader, chunk, STREAM_CHUNK_ACCESSES)) > 0) {
+        for (int i = 0; i < count; i++) shardsAccess(&sampler, chunk[i].page);
+    }
+    sampler.accesses = sampler.sampled + reader.skipped;
+
+    if (count == 0) {
+        fprintf(out, "frames,bytes,lru_aprox_faltas,lru_aprox_taxa\n");
+        for (int s = 0; s < numSizes; s++) {
+            double ratio = shardsMissRatio(&sampler, frameCounts[s]);
+            fprintf(out, "%d,%lld,%lld,%.6f\n", frameCounts[s], (long long)frameCounts[s] * g_pageSize,
+                    (long long)(ratio * sampler.accesses + 0.5), ratio);
+        }
+        printf("[curva] %d tamanhos gravados em %s (%lld de %lld acessos e %d páginas amostrados).\n",
+               numSizes, outPath, sampler.sampled, sampler.accesses, g_pageCount);
+    }
+
+    fclose(out);
+    free(chunk);
+    shardsFree(&sampler);
+    traceReaderClose(&reader);
+    return (count < 0) ? -1 : 0;
+}
@@ -0,0 +1,297 @@
+#include "simulator.h"
+
+// multiprogramação (--multiprog): cada processo (o pid no inicio da linha) tem o proprio espaço de
+// endereçamento, entao a pag "A" do pid 1 e a "A" do pid 2 sao paginas diferentes
+// compara dois jeitos de dividir a memoria:
+//  local: cada processo tem uma partição fixa de frames e so substitui as proprias pags
+//         (fixo = partes iguais, proporcional = proporcional ao working set medio do processo)
+//  global: um pool unico, qq processo pode tirar pag de qq outro
+// cada partição eh um job separado no runJobs, entao rodam em threads diferentes
+
+// tabela chave de 64 bits -> indice denso (endereçamento aberto, mesma ideia da tabela de paginas)
+typedef struct {
+    uint64_t* keys;
+    int* values;
+    uint32_t capacity; // potencia de 2
+    int count;
+} IdMap;
+
+#define IDMAP_EMPTY UINT64_MAX
+
+static void idMapInit(IdMap* map, uint32_t capacity) {
+    map->capacity = capacity;
+    map->count = 0;
+    map->keys = (uint64_t*)policyAlloc(capacity, sizeof(uint64_t));
+    map->values = (int*)policyAlloc(capacity, sizeof(int));
+    for (uint32_t i = 0; i < capacity; i++) map->keys[i] = IDMAP_EMPTY;
+}
+
+// mistura final do murmur3 de 64 bits (as chaves (processo, pag) sao quase sequenciais)
+static uint32_t mixKey(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return (uint32_t)key;
+}
+
+static uint32_t idMapSlot(const IdMap* map, uint64_t key) {
+    uint32_t mask = map->capacity - 1;
+    uint32_t i = mixKey(key) & mask;
+    while (map->keys[i] != IDMAP_EMPTY && map->keys[i] != key) i = (i + 1) & mask;
+    return i;
+}
+
+static void idMapGrow(IdMap* map) {
+    IdMap bigger;
+    idMapInit(&bigger, map->capacity * 2);
+    for (uint32_t i = 0; i < map->capacity; i++) {
+        if (map->keys[i] == IDMAP_EMPTY) continue;
+        uint32_t slot = idMapSlot(&bigger, map->keys[i]);
+        bigger.keys[slot] = map->keys[i];
+        bigger.values[slot] = map->values[i];
+    }
+    bigger.count = map->count;
+    free(map->keys);
+    free(map->values);
+    *map = bigger;
+}
+
+// indice da chave; se for nova recebe o proximo indice livre (*isNew = 1)
+static int idMapIntern(IdMap* map, uint64_t key, int* isNew) {
+    if (2 * (map->count + 1) > (int)map->capacity) idMapGrow(map); // ocupação <= 50%
+    uint32_t slot = idMapSlot(map, key);
+    *isNew = (map->keys[slot] == IDMAP_EMPTY);
+    if (*isNew) {
+        map->keys[slot] = key;
+        map->values[slot] = map->count++;
+    }
+    return map->values[slot];
+}
+
+static void idMapFree(IdMap* map) {
+    free(map->keys);
+    free(map->values);
+}
+
+typedef struct {
+    int pid;
+    int numAccesses;
+    int numPages;      // pags distintas do processo
+    int offset;        // inicio dos acessos dele em localSeq
+    double workingSet; // W(tau) medio no tempo virtual do processo
+    int frames;        // partição local
+    int* nextUse;      // so se alguma politica precisar do futuro
+} Process;
+
+// W(t, tau) = pags distintas nos ultimos tau acessos do processo; a janela desliza em O(1) por acesso
+// inWindow tem numPages posicoes zeradas e volta zerado
+static double meanWorkingSet(const PageAccess* seq, int numAccesses, int* inWindow) {
+    if (numAccesses == 0) return 0.0;
+    long long sum = 0;
+    int distinct = 0;
+    for (int i = 0; i < numAccesses; i++) {
+        if (inWindow[seq[i].page]++ == 0) distinct++;
+        if (i >= WORKING_SET_WINDOW && --inWindow[seq[i - WORKING_SET_WINDOW].page] == 0) distinct--;
+        sum += distinct;
+    }
+    int from = (numAccesses > WORKING_SET_WINDOW) ? numAccesses - WORKING_SET_WINDOW : 0;
+    for (int i = from; i < numAccesses; i++) inWindow[seq[i].page] = 0;
+    return (double)sum / numAccesses;
+}
+
+// divide os frames: 1 p cada processo e o resto em partes iguais ou proporcionais ao working set
+// (metodo do maior resto, entao a soma fecha exato)
+static void partitionFrames(Process* procs, int numProcs, int numFrames, int proportional) {
+    double total = 0;
+    for (int p = 0; p < numProcs; p++) total += proportional ? procs[p].workingSet : 1.0;
+    if (total <= 0) total = 1;
+
+    int spare = numFrames - numProcs;
+    int given = 0;
+    double* remainder = (double*)policyAlloc(numProcs, sizeof(double));
+    for (int p = 0; p < numProcs; p++) {
+        double share = spare * (proportional ? procs[p].workingSet : 1.0) / total;
+        procs[p].frames = 1 + (int)share;
+        remainder[p] = share - (int)share;
+        given += (int)share;
+    }
+    for (; given < spare; given++) {
+        int best = 0;
+        for (int p = 1; p < numProcs; p++) {
+            if (remainder[p] > remainder[best]) best = p;
+        }
+        procs[best].frames++;
+        remainder[best] = -1;
+    }
+    free(remainder);
+}
+
+int runMultiprogramming(const Trace* trace, const ReplacementPolicy** policies, int numPolicies, int numFrames,
+                        int proportional, int numThreads) {
+    int numAccesses = trace->numAccesses;
+    if (!trace->pids) {
+        fprintf(stderr, "[ERRO] o trace nao tem pids (o --multiprog precisa do formato texto \"<pid> <pagina>\").\n");
+        return -1;
+    }
+
+    // 1) pid -> processo e (processo, pag) -> indice denso global; o indice local eh dado na 1a vez no processo
+    IdMap procMap, pageMap;
+    idMapInit(&procMap, 64);
+    idMapInit(&pageMap, 1024);
+    int procCapacity = 16;
+    Process* procs = (Process*)policyAlloc(procCapacity, sizeof(Process));
+    int pageCapacity = 1024;
+    int* pageLocal = (int*)policyAlloc(pageCapacity, sizeof(int));
+    int* procOf = (int*)policyAlloc(numAccesses, sizeof(int));
+    PageAccess* globalSeq = (PageAccess*)policyAlloc(numAccesses, sizeof(PageAccess));
+
+    for (int i = 0; i < numAccesses; i++) {
+        int isNew;
+        int proc = idMapIntern(&procMap, (uint32_t)trace->pids[i], &isNew);
+        if (isNew) {
+            if (proc >= procCapacity) {
+                procs = (Process*)policyRealloc(procs, procCapacity, procCapacity * 2, sizeof(Process));
+                procCapacity *= 2;
+            }
+            procs[proc].pid = trace->pids[i];
+        }
+        int page = idMapIntern(&pageMap, ((uint64_t)proc << 32) | trace->accesses[i].page, &isNew);
+        if (isNew) {
+            if (page >= pageCapacity) {
+                pageLocal = (int*)policyRealloc(pageLocal, pageCapacity, pageCapacity * 2, sizeof(int));
+                pageCapacity *= 2;
+            }
+            pageLocal[page] = procs[proc].numPages++;
+        }
+        procOf[i] = proc;
+        globalSeq[i].page = (uint32_t)page;
+        procs[proc].numAccesses++;
+    }
+    int numProcs = procMap.count;
+    int totalPages = pageMap.count;
+    idMapFree(&procMap);
+    idMapFree(&pageMap);
+
+    if (numFrames < numProcs) {
+        fprintf(stderr, "[ERRO] %d frames não dão nem 1 frame para cada um dos %d processos.\n", numFrames, numProcs);
+        free(procs);
+        free(pageLocal);
+        free(procOf);
+        free(globalSeq);
+        return -1;
+    }
+
+    // 2) sequencia local de cada processo (na ordem original), com os indices locais
+    PageAccess* localSeq = (PageAccess*)policyAlloc(numAccesses, sizeof(PageAccess));
+    int* fill = (int*)policyAlloc(numProcs, sizeof(int));
+    for (int p = 1; p < numProcs; p++) procs[p].offset = procs[p - 1].offset + procs[p - 1].numAccesses;
+    for (int i = 0; i < numAccesses; i++) {
+        int proc = procOf[i];
+        localSeq[procs[proc].offset + fill[proc]++].page = (uint32_t)pageLocal[globalSeq[i].page];
+    }
+    free(fill);
+
+    // pag global -> processo (p somar as faltas do pool global por processo)
+    int* pageProc = (int*)policyAlloc(totalPages, sizeof(int));
+    for (int i = 0; i < numAccesses; i++) pageProc[globalSeq[i].page] = procOf[i];
+    free(procOf);
+
+    // 3) working set medio e partições
+    int maxPages = 1;
+    for (int p = 0; p < numProcs; p++) {
+        if (procs[p].numPages > maxPages) maxPages = procs[p].numPages;
+    }
+    int* inWindow = (int*)policyAlloc(maxPages, sizeof(int));
+    for (int p = 0; p < numProcs; p++) {
+        procs[p].workingSet = meanWorkingSet(localSeq + procs[p].offset, procs[p].numAccesses, inWindow);
+    }
+    free(inWindow);
+    partitionFrames(procs, numProcs, numFrames, proportional);
+
+    int needsFuture = 0;
+    for (int k = 0; k < numPolicies; k++) needsFuture |= policies[k]->needsFuture;
+    int* globalNextUse = NULL;
+    if (needsFuture) {
+        printf("[OTIMO] pre processando o pool global e %d processos...\n", numProcs);
+        globalNextUse = computeNextUse(globalSeq, numAccesses, totalPages);
+        for (int p = 0; p < numProcs; p++) {
+            procs[p].nextUse = computeNextUse(localSeq + procs[p].offset, procs[p].numAccesses, procs[p].numPages);
+        }
+    }
+
+    // 4) jobs: por politica, o pool global (com carregamentos por pag) + uma partição por processo
+    int perPolicy = numProcs + 1;
+    int numJobs = numPolicies * perPolicy;
+    SimJob* jobs = (SimJob*)policyAlloc(numJobs, sizeof(SimJob));
+    for (int k = 0; k < numPolicies; k++) {
+        SimJob* global = &jobs[k * perPolicy];
+        global->policy = policies[k];
+        global->numFrames = numFrames;
+        global->loads = (int*)policyAlloc(totalPages, sizeof(int));
+        global->sequence = globalSeq;
+        global->nextUse = globalNextUse;
+        global->numAccesses = numAccesses;
+        global->numPages = totalPages;
+        for (int p = 0; p < numProcs; p++) {
+            SimJob* local = &jobs[k * perPolicy + 1 + p];
+            local->policy = policies[k];
+            local->numFrames = procs[p].frames;
+            local->sequence = localSeq + procs[p].offset;
+            local->nextUse = procs[p].nextUse;
+            local->numAccesses = procs[p].numAccesses;
+            local->numPages = procs[p].numPages;
+        }
+    }
+
+    printf("\nexecutando %d processos em partições %s e no pool global (%d jobs)...\n",
+           numProcs, proportional ? "proporcionais ao working set" : "fixas", numJobs);
+    runJobs(jobs, numJobs, NULL, NULL, 0, numThreads);
+
+    // 5) RELATÓRIO: uma tabela por politica
+    long long* globalFaults = (long long*)policyAlloc(numProcs, sizeof(long long));
+    printf("\nRELATÓRIO (multiprogramação):\n");
+    printf("a memória física comporta %d páginas, %d processos, %d páginas distintas no total.\n",
+           numFrames, numProcs, totalPages);
+    for (int k = 0; k < numPolicies; k++) {
+        SimJob* global = &jobs[k * perPolicy];
+        memset(globalFaults, 0, numProcs * sizeof(long long));
+        for (int page = 0; page < totalPages; page++) globalFaults[pageProc[page]] += global->loads[page];
+
+        printf("\n%s (ws com tau = %d acessos):\n", policies[k]->label, WORKING_SET_WINDOW);
+        printf("%-10s %12s %10s %10s %8s %14s %14s\n", "pid", "acessos", "páginas", "ws médio", "frames",
+               "faltas local", "faltas global");
+        for (int i = 0; i < 10 + 13 + 11 + 11 + 9 + 15 + 15; i++) putchar('-');
+        printf("\n");
+        long long localTotal = 0;
+        for (int p = 0; p < numProcs; p++) {
+            long long localFaults = jobs[k * perPolicy + 1 + p].faults;
+            localTotal += localFaults;
+            printf("%-10d %12d %10d %10.1f %8d %14lld %14lld\n", procs[p].pid, procs[p].numAccesses, procs[p].numPages,
+                   procs[p].workingSet, procs[p].frames, localFaults, globalFaults[p]);
+        }
+        printf("%-10s %12d %10d %10s %8d %14lld %14lld\n", "total", numAccesses, totalPages, "-", numFrames,
+               localTotal, global->faults);
+    }
+
+    for (int j = 0; j < numJobs; j++) {
+        char phaseName[48];
+        if (j % perPolicy == 0) snprintf(phaseName, sizeof(phaseName), "%s global", jobs[j].policy->name);
+        else snprintf(phaseName, sizeof(phaseName), "%s pid %d", jobs[j].policy->name, procs[j % perPolicy - 1].pid);
+        statsRecord(phaseName, jobs[j].stats.wallSeconds, jobs[j].stats.cpuSeconds, jobs[j].numAccesses, jobs[j].faults,
+                    jobs[j].stats.scanSteps);
+        free(jobs[j].loads);
+    }
+
+    free(globalFaults);
+    free(jobs);
+    free(globalNextUse);
+    for (int p = 0; p < numProcs; p++) free(procs[p].nextUse);
+    free(procs);
+    free(pageLocal);
+    free(pageProc);
+    free(localSeq);
+    free(globalSeq);
+    return 0;
+}
@@ -1,169 +1,83 @@
 #include "simulator.h"
 
-// funçao aux pra verificar presença da pag usando a tabela hash aux
-// otimizacao da rapidez do algoritmo
-static int isPageInFrames(PresenceNode* presenceMap[], const char* page_id) {
-    unsigned int index = hashOptimize(page_id);
-    PresenceNode* current = presenceMap[index];
-
-    // percorre a lista e procura a pagina 
-    while(current) {
-        if(strcmp(current->page_id, page_id) == 0) return 1;
-        current = current->next;
-    }
-    return 0;
+// ÓTIMO: substitui a pag que vai demorar mais p ser usada de novo
+// as pags residentes ficam num heap de maximo indexado por slot com chave = proximo uso,
+// entao cada acesso custa O(log frames) em vez de varrer todos os frames
+
+typedef struct {
+    MaxHeap heap;
+    uint32_t* pageAt; // pag em cada slot
+} OptimalState;
+
+static void* optimalCreate(int numFrames, int numPages) {
+    OptimalState* state = (OptimalState*)policyAlloc(1, sizeof(OptimalState));
+    heapInit(&state->heap, numFrames);
+    state->pageAt = (uint32_t*)policyAlloc(numFrames, sizeof(uint32_t));
+    return state;
 }
 
-// controla quais pag tao na memoria fisica
-static void updatePresence(PresenceNode* presenceMap[], const char* page_id, int add) {
-    unsigned int index = hashOptimize(page_id); 
-
-    if (add) { // adiciona a pag
-        PresenceNode* newNode = (PresenceNode*)malloc(sizeof(PresenceNode));
-        if (!newNode) { // verifica se deu p alocar
-            perror("falha ao alocar memoria para nodo de presença");
-            exit(1);
-        }
-
-        strcpy(newNode->page_id, page_id);
-        newNode->next = presenceMap[index]; // tabela hash q mapeia pagina presente 
-        presenceMap[index] = newNode;
-    } else { // remove a pag
-        PresenceNode* current = presenceMap[index];
-        PresenceNode* prev = NULL;
-
-        // percorre a lista de presença p achar a pag
-        while(current) {
-            if(strcmp(current->page_id, page_id) == 0) { // achou
-                if(prev) prev->next = current->next;
-                else presenceMap[index] = current->next;
-                free(current); // libera memoria
-                return;
-            }
-
-            prev = current;
-            current = current->next;
-        }
-    }
+// hit: so atualiza o proximo uso da pag
+static void optimalOnHit(void* raw, uint32_t page, int slot, long long nextUse) {
+    OptimalState* state = (OptimalState*)raw;
+    heapUpdate(&state->heap, slot, nextUse);
 }
 
-// otimo encontra a pag que vai ser usada mais tarde
-static int getNextUse(HashNode* node, int currentIndex) {
-    // avança o pointer ate encontrar um uso futuro que seja depois do indice atual
-    while (node -> nextUsePointer < node -> numFutureUses &&
-           node -> futureUses[node -> nextUsePointer] <= currentIndex) {
-        node->nextUsePointer++;
-    }
-
-    // se ainda tiver usos futuros retorna o proximo
-    if (node -> nextUsePointer < node -> numFutureUses) {
-        return node->futureUses[node->nextUsePointer];
-    }
-
-    return INT_MAX;
+// topo do heap = pag usada mais tarde (ou nunca mais); empate fica com o menor slot
+static uint32_t optimalChooseVictim(void* raw, uint32_t page) {
+    OptimalState* state = (OptimalState*)raw;
+    return state->pageAt[heapTop(&state->heap)];
 }
 
-// retorna a quantidade de faltas de pag q ocorreram
-int runOptimalSimulation(PageAccess * accessSequence, int numAccesses, int numPhysicalPages) {
-
-    //aloca os frames da mem fisica
-    char **frames = malloc(numPhysicalPages * sizeof(char *)); 
-    for (int i = 0; i < numPhysicalPages; i++) frames[i] = NULL;
-
-    int pageFaults = 0;
-
-    PresenceNode* presenceMap[HASH_TABLE_SIZE];
-    for(int i = 0; i < HASH_TABLE_SIZE; i++) presenceMap[i] = NULL;
-
-
-    for (int i = 0; i < numAccesses; i++) {
-        if (i > 0 && i % LOG_INTERVAL == 0) {
-            printf("[otimo] processando acesso %d de %d...\n", i, numAccesses);
-        }
-
-        char *currentPage = accessSequence[i].page_id;
-
-        int pageFound = isPageInFrames(presenceMap, currentPage);
-
-        char* victimPageId = NULL; // armazena pag que vai ser removida no futuro
-        int slotIndex = -1;
-
-        if (!pageFound) {
-            pageFaults++;
-            incrementLoadCount(currentPage, "optimal");
-
-            if (g_verbose) {
-                printf("[otimo] page fault #%d (acesso #%d): página '%s' não encontrada.\n", pageFaults, i + 1, currentPage);
-            }
-
-            // procura um slot vazio p bota a pag nova
-            int emptySlot = -1;
-            for (int j = 0; j < numPhysicalPages; j++) {
-                if (frames[j] == NULL) {
-                    emptySlot = j; 
-                    break;
-                }
-            }
-
-            // aloca no espaço vazio 
-            if (emptySlot != -1) {
-                frames[emptySlot] = currentPage;
-                updatePresence(presenceMap, currentPage, 1); // adiciona na tabela de presença
-                slotIndex = emptySlot;
-                if (g_verbose) {
-                    printf("inserido em: %d.\n", emptySlot);
-                }
-            } else {
-                int victim = -1;
-                int farthest = -1; // mais longe de ser usado dnv
-
-                for (int j = 0; j < numPhysicalPages; j++) { 
-                    HashNode* frameNode = findNode(frames[j]); // da as infos de processamento da pag e seu usos futuros
-
-                    int nextUse = getNextUse(frameNode, i); 
-
-                    if (nextUse == INT_MAX) { // nunca mais usada
-                        victim = j;
-                        break;
-                    }
-
-                    if (nextUse > farthest) { // acha a pag que vai ser usada mais tarde
-                        farthest = nextUse;
-                        victim = j;
-                    }
-                }
+static void optimalOnMiss(void* raw, uint32_t page, int slot, long long nextUse) {
+    OptimalState* state = (OptimalState*)raw;
+    state->pageAt[slot] = page;
+    // slots sao ocupados em ordem: se o slot ja ta no heap, eh o slot da vitima sendo reaproveitado
+    if (slot < state->heap.size) heapUpdate(&state->heap, slot, nextUse);
+    else heapPush(&state->heap, slot, nextUse);
+}
 
-                victimPageId = strdup(frames[victim]);
-                slotIndex = victim;
+static void optimalDestroy(void* raw) {
+    OptimalState* state = (OptimalState*)raw;
+    heapFree(&state->heap);
+    free(state->pageAt);
+    free(state);
+}
 
-                if (g_verbose) {
-                    printf("substituindo página '%s' na posição %d por '%s'.\n", frames[victim], victim, currentPage);
-                }
-                
-                updatePresence(presenceMap, frames[victim], 0); // remove vítima
-                frames[victim] = currentPage;
-                updatePresence(presenceMap, currentPage, 1);     // adiciona nova página
-            }
-        }
+// trocas no heap (hits e faltas), o equivalente da antiga varredura dos frames
+static long long optimalScanSteps(void* raw) {
+    OptimalState* state = (OptimalState*)raw;
+    return state->heap.steps;
+}
 
-        // verbose p mostra em tempo real cada troca
-        if (g_didaticMode && g_verbose && !pageFound) {
-            displayFrameState("otimo", numPhysicalPages, frames, currentPage, victimPageId, slotIndex);
-        }
+// checkpoint: os slots ocupados sao 0..usedFrames-1, entao so essa parte do heap tem dado
+static void optimalSave(void* raw, int usedFrames, int numPages, FILE* out) {
+    OptimalState* state = (OptimalState*)raw;
+    checkpointWrite(out, &state->heap.size, sizeof(int));
+    checkpointWrite(out, &state->heap.steps, sizeof(long long));
+    checkpointWrite(out, state->heap.slots, state->heap.size * sizeof(int));
+    checkpointWrite(out, state->heap.position, usedFrames * sizeof(int));
+    checkpointWrite(out, state->heap.key, usedFrames * sizeof(long long));
+    checkpointWrite(out, state->pageAt, usedFrames * sizeof(uint32_t));
+}
 
-        free(victimPageId);
-    }
-    
-    // limpeza da tabela hash de presença
-    for(int i = 0; i < HASH_TABLE_SIZE; i++) {
-        PresenceNode* current = presenceMap[i];
-        while(current) {
-            PresenceNode* temp = current;
-            current = current->next;
-            free(temp);
-        }
+static int optimalRestore(void* raw, int usedFrames, int numPages, const int* slotOf, FILE* in) {
+    OptimalState* state = (OptimalState*)raw;
+    if (checkpointRead(in, &state->heap.size, sizeof(int)) != 0 || state->heap.size != usedFrames) return -1;
+    if (checkpointRead(in, &state->heap.steps, sizeof(long long)) != 0) return -1;
+    if (checkpointRead(in, state->heap.slots, usedFrames * sizeof(int)) != 0) return -1;
+    if (checkpointRead(in, state->heap.position, usedFrames * sizeof(int)) != 0) return -1;
+    if (checkpointRead(in, state->heap.key, usedFrames * sizeof(long long)) != 0) return -1;
+    if (checkpointRead(in, state->pageAt, usedFrames * sizeof(uint32_t)) != 0) return -1;
+    // slots e posicoes viram indices do heap: tem q ser uma permutação de 0..usedFrames-1
+    for (int i = 0; i < usedFrames; i++) {
+        int slot = state->heap.slots[i];
+        if (slot < 0 || slot >= usedFrames || state->heap.position[slot] != i) return -1;
+        if (state->pageAt[i] >= (uint32_t)numPages || slotOf[state->pageAt[i]] != i) return -1;
     }
+    return 0;
+}
 
-    free(frames); // libera mem fisica
-    return pageFaults;
-}
\ No newline at end of file
+const ReplacementPolicy optimalPolicy = {
+    "otimo", "ÓTIMO", 1, optimalCreate, optimalOnHit, optimalChooseVictim, optimalOnMiss, optimalDestroy, optimalScanSteps, NULL,
+    optimalSave, optimalRestore
+};
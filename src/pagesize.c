@@ -0,0 +1,264 @@
+#include "simulator.h"
+#include <sys/mman.h>
+
+// tamanho de pagina em tempo de execução (--page-size) e pags enormes misturadas (--huge)
+//
+// os ids do trace sao pags de 4KB ("D2513" = pag 2513 da regiao "D"). com pag maior, 2^shift pags do
+// trace viram uma so: o trace eh renomeado uma vez na carga ("D2513" com 2MB -> "D4") e as simulações
+// continuam iguais, entao o tamanho da pag nao entra no laço de cada acesso
+//
+// no --huge as regioes mais acessadas viram pags enormes num pool reservado (como o hugetlbfs) e o
+// resto continua com a pag base no restante da memoria
+
+long long g_pageSize = PAGE_SIZE_BYTES;
+
+// log2(pageSize / 4KB), ou -1 se nao for potencia de 2 a partir de 4KB
+int pageSizeShift(long long pageSize) {
+    if (pageSize < PAGE_SIZE_BYTES || pageSize % PAGE_SIZE_BYTES != 0) return -1;
+    long long ratio = pageSize / PAGE_SIZE_BYTES;
+    if (ratio & (ratio - 1)) return -1;
+    int shift = 0;
+    while ((1LL << shift) < ratio) shift++;
+    return shift;
+}
+
+// separa "D2513" em prefixo "D" (prefixLen = 1) e numero 2513; 0 = id sem numero no fim
+int splitPageId(const char* id, size_t* prefixLen, uint64_t* number) {
+    size_t len = strlen(id);
+    size_t digits = len;
+    while (digits > 0 && id[digits - 1] >= '0' && id[digits - 1] <= '9') digits--;
+    *prefixLen = digits;
+    if (digits == len) return 0;
+    *number = strtoull(id + digits, NULL, 10);
+    return 1;
+}
+
+// nome da pag maior q contem a pag base (ids sem numero ficam como estao)
+static void groupName(const char* id, int shift, char* out) {
+    size_t prefixLen;
+    uint64_t number;
+    if (!splitPageId(id, &prefixLen, &number)) {
+        snprintf(out, MAX_PAGE_ID_LEN, "%s", id);
+        return;
+    }
+    snprintf(out, MAX_PAGE_ID_LEN, "%.*s%llu", (int)prefixLen, id, (unsigned long long)(number >> shift));
+}
+
+// renomeia as pags do trace p pags 2^shift vezes maiores: a tabela hash eh refeita so com as pags novas
+void applyPageSize(Trace* trace, int shift) {
+    if (shift == 0) return;
+    int oldCount = g_pageCount;
+    char (*names)[MAX_PAGE_ID_LEN] = malloc((oldCount > 0 ? oldCount : 1) * sizeof(*names));
+    uint32_t* newId = (uint32_t*)malloc((oldCount > 0 ? oldCount : 1) * sizeof(uint32_t));
+    if (!names || !newId) {
+        perror("falha ao alocar memoria para trocar o tamanho da pagina");
+        exit(1);
+    }
+    for (int p = 0; p < oldCount; p++) groupName(pageName(p), shift, names[p]);
+
+    cleanHashTable();
+    hashInit();
+    for (int p = 0; p < oldCount; p++) newId[p] = registerPage(names[p]);
+
+    // o .mtr mapeado eh so leitura: a sequencia vira uma copia
+    if (trace->mapping) {
+        PageAccess* copy = (PageAccess*)malloc((trace->numAccesses > 0 ? trace->numAccesses : 1) * sizeof(PageAccess));
+        if (!copy) {
+            perror("falha ao alocar memoria para a sequencia de acessos");
+            exit(1);
+        }
+        memcpy(copy, trace->accesses, trace->numAccesses * sizeof(PageAccess));
+        munmap(trace->mapping, trace->mappingSize);
+        trace->mapping = NULL;
+        trace->mappingSize = 0;
+        trace->accesses = copy;
+    }
+    for (int i = 0; i < trace->numAccesses; i++) trace->accesses[i].page = newId[trace->accesses[i].page];
+
+    free(names);
+    free(newId);
+}
+
+typedef struct {
+    uint64_t key;  // regiao do prefixo << 40 | numero da pag enorme
+    uint32_t page; // pag base
+} RegionKey;
+
+static int compareRegionKeys(const void* a, const void* b) {
+    uint64_t x = ((const RegionKey*)a)->key;
+    uint64_t y = ((const RegionKey*)b)->key;
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    int region;
+    long long accesses;
+} RegionHeat;
+
+static int compareHeat(const void* a, const void* b) {
+    long long x = ((const RegionHeat*)a)->accesses;
+    long long y = ((const RegionHeat*)b)->accesses;
+    return (x < y) - (x > y); // mais acessada primeiro
+}
+
+int runHugePages(Trace* trace, const ReplacementPolicy** policies, int numPolicies, long long memBytes,
+                 long long hugeSize, double hugeShare, int numThreads) {
+    int shift = pageSizeShift(hugeSize) - pageSizeShift(g_pageSize);
+    if (shift <= 0) {
+        fprintf(stderr, "[ERRO] a pag enorme (%lld bytes) tem que ser maior que a pag base (%lld bytes).\n", hugeSize, g_pageSize);
+        return -1;
+    }
+    int hugeFrames = (int)(memBytes * hugeShare / hugeSize);
+    int baseFrames = (int)((memBytes - (long long)hugeFrames * hugeSize) / g_pageSize);
+    if (hugeFrames < 1 || baseFrames < 1) {
+        fprintf(stderr, "[ERRO] a memória não dá para reservar pags enormes de %lld bytes e ainda sobrar pags base.\n", hugeSize);
+        return -1;
+    }
+    int numAccesses = trace->numAccesses;
+    int numPages = g_pageCount;
+
+    // 1) regioes: pags base com o mesmo prefixo e o mesmo numero >> shift (ids sem numero nao tem regiao)
+    char prefixes[256][MAX_PAGE_ID_LEN];
+    int numPrefixes = 0;
+    RegionKey* keys = (RegionKey*)policyAlloc(numPages, sizeof(RegionKey));
+    int numKeys = 0;
+    for (int p = 0; p < numPages; p++) {
+        size_t prefixLen;
+        uint64_t number;
+        const char* id = pageName(p);
+        if (!splitPageId(id, &prefixLen, &number)) continue;
+        int prefix = 0;
+        while (prefix < numPrefixes && (strlen(prefixes[prefix]) != prefixLen || strncmp(prefixes[prefix], id, prefixLen) != 0)) prefix++;
+        if (prefix == numPrefixes) {
+            if (numPrefixes == 256) continue; // prefixos demais: o resto fica so com pag base
+            memcpy(prefixes[numPrefixes], id, prefixLen);
+            prefixes[numPrefixes++][prefixLen] = '\0';
+        }
+        keys[numKeys].key = ((uint64_t)prefix << 40) | ((number >> shift) & ((1ULL << 40) - 1));
+        keys[numKeys].page = (uint32_t)p;
+        numKeys++;
+    }
+    qsort(keys, numKeys, sizeof(RegionKey), compareRegionKeys);
+
+    int* regionOf = (int*)policyAlloc(numPages, sizeof(int));
+    for (int p = 0; p < numPages; p++) regionOf[p] = -1;
+    int numRegions = 0;
+    for (int k = 0; k < numKeys; k++) {
+        if (k > 0 && keys[k].key != keys[k - 1].key) numRegions++;
+        regionOf[keys[k].page] = numRegions;
+    }
+    if (numKeys > 0) numRegions++;
+    free(keys);
+
+    // 2) promove as regioes mais acessadas, ate encher o pool de pags enormes
+    RegionHeat* heat = (RegionHeat*)policyAlloc(numRegions, sizeof(RegionHeat));
+    for (int r = 0; r < numRegions; r++) heat[r].region = r;
+    for (int i = 0; i < numAccesses; i++) {
+        int region = regionOf[trace->accesses[i].page];
+        if (region >= 0) heat[region].accesses++;
+    }
+    qsort(heat, numRegions, sizeof(RegionHeat), compareHeat);
+    int* hugeId = (int*)policyAlloc(numRegions, sizeof(int)); // regiao -> indice denso no pool enorme (-1 = nao promovida)
+    for (int r = 0; r < numRegions; r++) hugeId[r] = -1;
+    int promoted = (numRegions < hugeFrames) ? numRegions : hugeFrames;
+    long long hotAccesses = 0;
+    for (int h = 0; h < promoted; h++) {
+        hugeId[heat[h].region] = h;
+        hotAccesses += heat[h].accesses;
+    }
+    free(heat);
+
+    // 3) sequencias dos dois pools (indices densos proprios)
+    int* baseId = (int*)policyAlloc(numPages, sizeof(int));
+    int numBase = 0;
+    for (int p = 0; p < numPages; p++) {
+        baseId[p] = (regionOf[p] >= 0 && hugeId[regionOf[p]] >= 0) ? -1 : numBase++;
+    }
+    PageAccess* baseSeq = (PageAccess*)policyAlloc(numAccesses, sizeof(PageAccess));
+    PageAccess* hugeSeq = (PageAccess*)policyAlloc(hotAccesses, sizeof(PageAccess));
+    int baseCount = 0, hugeCount = 0;
+    for (int i = 0; i < numAccesses; i++) {
+        uint32_t page = trace->accesses[i].page;
+        if (baseId[page] >= 0) baseSeq[baseCount++].page = (uint32_t)baseId[page];
+        else hugeSeq[hugeCount++].page = (uint32_t)hugeId[regionOf[page]];
+    }
+    free(regionOf);
+    free(hugeId);
+    free(baseId);
+
+    int needsFuture = 0;
+    for (int k = 0; k < numPolicies; k++) needsFuture |= policies[k]->needsFuture;
+    int* allNextUse = NULL;
+    int* baseNextUse = NULL;
+    int* hugeNextUse = NULL;
+    if (needsFuture) {
+        printf("[OTIMO] pre processando a sequencia inteira e os dois pools...\n");
+        allNextUse = computeNextUse(trace->accesses, numAccesses, numPages);
+        baseNextUse = computeNextUse(baseSeq, baseCount, numBase);
+        hugeNextUse = computeNextUse(hugeSeq, hugeCount, promoted);
+    }
+
+    // 4) por politica: so pags base na memoria toda (referencia) x pool base + pool enorme
+    int numJobs = numPolicies * 3;
+    SimJob* jobs = (SimJob*)policyAlloc(numJobs, sizeof(SimJob));
+    for (int k = 0; k < numPolicies; k++) {
+        SimJob* all = &jobs[k * 3];
+        all->policy = policies[k];
+        all->numFrames = (int)(memBytes / g_pageSize);
+        all->sequence = trace->accesses;
+        all->nextUse = allNextUse;
+        all->numAccesses = numAccesses;
+        all->numPages = numPages;
+
+        SimJob* base = &jobs[k * 3 + 1];
+        base->policy = policies[k];
+        base->numFrames = baseFrames;
+        base->sequence = baseSeq;
+        base->nextUse = baseNextUse;
+        base->numAccesses = baseCount;
+        base->numPages = numBase;
+
+        SimJob* huge = &jobs[k * 3 + 2];
+        huge->policy = policies[k];
+        huge->numFrames = hugeFrames;
+        huge->sequence = hugeSeq;
+        huge->nextUse = hugeNextUse;
+        huge->numAccesses = hugeCount;
+        huge->numPages = promoted;
+    }
+    printf("\nexecutando com pags de %lld bytes e pags enormes de %lld bytes (%d jobs)...\n", g_pageSize, hugeSize, numJobs);
+    runJobs(jobs, numJobs, NULL, NULL, 0, numThreads);
+
+    // 5) RELATÓRIO
+    printf("\nRELATÓRIO (pags enormes):\n");
+    printf("pool base: %d frames de %lld bytes; pool enorme: %d frames de %lld bytes (%.0f%% da memória).\n",
+           baseFrames, g_pageSize, hugeFrames, hugeSize, 100.0 * hugeFrames * hugeSize / memBytes);
+    printf("%d de %d regiões promovidas, com %d das %d páginas base e %.1f%% dos acessos.\n", promoted, numRegions,
+           numPages - numBase, numPages, numAccesses ? 100.0 * hotAccesses / numAccesses : 0.0);
+    printf("entradas na tabela de páginas: %d só com pags base, %d misturando (%lld x %lld bytes).\n", numPages,
+           numBase + promoted, (long long)numPages * 8, (long long)(numBase + promoted) * 8);
+    printf("\n%-10s %16s %14s %14s %14s\n", "política", "só pag base", "pool base", "pool enorme", "misto");
+    for (int i = 0; i < 10 + 17 + 15 + 15 + 15; i++) putchar('-');
+    printf("\n");
+    for (int k = 0; k < numPolicies; k++) {
+        long long mixed = jobs[k * 3 + 1].faults + jobs[k * 3 + 2].faults;
+        printf("%-10s %16lld %14lld %14lld %14lld\n", policies[k]->name, jobs[k * 3].faults, jobs[k * 3 + 1].faults,
+               jobs[k * 3 + 2].faults, mixed);
+    }
+
+    static const char* jobNames[] = { "so base", "pool base", "pool enorme" };
+    for (int j = 0; j < numJobs; j++) {
+        char phaseName[48];
+        snprintf(phaseName, sizeof(phaseName), "%s %s", jobs[j].policy->name, jobNames[j % 3]);
+        statsRecord(phaseName, jobs[j].stats.wallSeconds, jobs[j].stats.cpuSeconds, jobs[j].numAccesses, jobs[j].faults,
+                    jobs[j].stats.scanSteps);
+    }
+
+    free(jobs);
+    free(allNextUse);
+    free(baseNextUse);
+    free(hugeNextUse);
+    free(baseSeq);
+    free(hugeSeq);
+    return 0;
+}
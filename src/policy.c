@@ -0,0 +1,265 @@
+#include "simulator.h"
+
+// driver comum das politicas de substituição: frames, presença, contagem de faltas e logs
+// a politica so ve on-hit, on-miss e escolha da vitima
+
+static const ReplacementPolicy* const policies[] = {
+    &optimalPolicy, &fifoPolicy, &lruPolicy, &clockPolicy, &lfuPolicy, &arcPolicy, &twoQPolicy
+};
+#define NUM_POLICIES ((int)(sizeof(policies) / sizeof(policies[0])))
+
+const ReplacementPolicy* findPolicy(const char* name) {
+    for (int i = 0; i < NUM_POLICIES; i++) {
+        if (strcmp(policies[i]->name, name) == 0) return policies[i];
+    }
+    return NULL;
+}
+
+// converte "otimo,fifo,lru" (ou "all") em politicas; retorna a qtde ou -1 se alguma nao existir
+int parsePolicyList(const char* list, const ReplacementPolicy** out, int maxPolicies) {
+    if (strcmp(list, "all") == 0) {
+        int count = (NUM_POLICIES < maxPolicies) ? NUM_POLICIES : maxPolicies;
+        for (int i = 0; i < count; i++) out[i] = policies[i];
+        return count;
+    }
+
+    int count = 0;
+    char name[32];
+    while (*list) {
+        size_t len = strcspn(list, ",");
+        if (len == 0 || len >= sizeof(name) || count >= maxPolicies) return -1;
+        memcpy(name, list, len);
+        name[len] = '\0';
+        list += len;
+        if (*list == ',') list++;
+
+        const ReplacementPolicy* policy = findPolicy(name);
+        if (!policy) return -1;
+
+        int repeated = 0;
+        for (int i = 0; i < count; i++) repeated |= (out[i] == policy);
+        if (!repeated) out[count++] = policy;
+    }
+    return (count > 0) ? count : -1;
+}
+
+void* policyAlloc(size_t count, size_t size) {
+    if (g_stats) __atomic_fetch_add(&g_counters.policyAllocs, 1, __ATOMIC_RELAXED); // jobs alocam em paralelo
+    void* ptr = calloc(count > 0 ? count : 1, size);
+    if (!ptr) {
+        perror("falha ao alocar memoria para a politica");
+        exit(1);
+    }
+    return ptr;
+}
+
+void* policyRealloc(void* ptr, size_t oldCount, size_t newCount, size_t size) {
+    if (g_stats) __atomic_fetch_add(&g_counters.policyAllocs, 1, __ATOMIC_RELAXED);
+    ptr = realloc(ptr, (newCount > 0 ? newCount : 1) * size);
+    if (!ptr) {
+        perror("falha ao realocar memoria para a politica");
+        exit(1);
+    }
+    if (newCount > oldCount) memset((char*)ptr + oldCount * size, 0, (newCount - oldCount) * size);
+    return ptr;
+}
+
+void pageLinksInit(PageLinks* links, int numPages) {
+    links->prev = (uint32_t*)policyAlloc(numPages, sizeof(uint32_t));
+    links->next = (uint32_t*)policyAlloc(numPages, sizeof(uint32_t));
+}
+
+void pageLinksGrow(PageLinks* links, int oldPages, int numPages) {
+    links->prev = (uint32_t*)policyRealloc(links->prev, oldPages, numPages, sizeof(uint32_t));
+    links->next = (uint32_t*)policyRealloc(links->next, oldPages, numPages, sizeof(uint32_t));
+}
+
+void pageLinksSave(const PageLinks* links, int numPages, FILE* out) {
+    checkpointWrite(out, links->prev, numPages * sizeof(uint32_t));
+    checkpointWrite(out, links->next, numPages * sizeof(uint32_t));
+}
+
+int pageLinksRestore(PageLinks* links, int numPages, FILE* in) {
+    if (checkpointRead(in, links->prev, numPages * sizeof(uint32_t)) != 0) return -1;
+    if (checkpointRead(in, links->next, numPages * sizeof(uint32_t)) != 0) return -1;
+    for (int p = 0; p < numPages; p++) {
+        if (!checkpointPageOk(links->prev[p], numPages) || !checkpointPageOk(links->next[p], numPages)) return -1;
+    }
+    return 0;
+}
+
+// anda pela lista (no maximo size passos, entao ciclo nao prende): cada pag valida, com o link de volta certo,
+// residente ou nao conforme resident e, se where != NULL, marcada como where[pag] == which
+int pageListCheck(const PageList* list, const PageLinks* links, int numPages, int maxSize, const int* slotOf, int resident,
+                  const unsigned char* where, int which) {
+    if (list->size < 0 || list->size > maxSize) return -1;
+    uint32_t prev = PAGE_NONE;
+    uint32_t page = list->head;
+    for (int i = 0; i < list->size; i++) {
+        if (page >= (uint32_t)numPages || links->prev[page] != prev) return -1;
+        if ((slotOf[page] >= 0) != resident || (where && where[page] != which)) return -1;
+        prev = page;
+        page = links->next[page];
+    }
+    return (page == PAGE_NONE && list->tail == prev) ? 0 : -1;
+}
+
+void pageLinksFree(PageLinks* links) {
+    free(links->prev);
+    free(links->next);
+}
+
+void pageListInit(PageList* list) {
+    list->head = PAGE_NONE;
+    list->tail = PAGE_NONE;
+    list->size = 0;
+}
+
+void pageListPushFront(PageList* list, PageLinks* links, uint32_t page) {
+    links->prev[page] = PAGE_NONE;
+    links->next[page] = list->head;
+    if (list->head != PAGE_NONE) links->prev[list->head] = page;
+    else list->tail = page;
+    list->head = page;
+    list->size++;
+}
+
+void pageListRemove(PageList* list, PageLinks* links, uint32_t page) {
+    uint32_t prev = links->prev[page];
+    uint32_t next = links->next[page];
+    if (prev != PAGE_NONE) links->next[prev] = next;
+    else list->head = next;
+    if (next != PAGE_NONE) links->prev[next] = prev;
+    else list->tail = prev;
+    list->size--;
+}
+
+uint32_t pageListPopBack(PageList* list, PageLinks* links) {
+    uint32_t page = list->tail;
+    if (page != PAGE_NONE) pageListRemove(list, links, page);
+    return page;
+}
+
+void simInit(Simulation* sim, const ReplacementPolicy* policy, int numFrames, int numPages, int* loads, int verbose) {
+    sim->policy = policy;
+    sim->state = policy->create(numFrames, numPages);
+    sim->numFrames = numFrames;
+    sim->usedFrames = 0;
+    sim->numPages = numPages;
+    sim->faults = 0;
+    sim->loads = loads;
+    sim->hitters = NULL;
+    sim->logSource = verbose ? eventLogSource(policy->name, numFrames) : -1;
+
+    sim->frames = (uint32_t*)policyAlloc(numFrames, sizeof(uint32_t));
+    sim->slotOf = (int*)policyAlloc(numPages, sizeof(int));
+    for (int i = 0; i < numFrames; i++) sim->frames[i] = PAGE_NONE;
+    for (int i = 0; i < numPages; i++) sim->slotOf[i] = -1;
+}
+
+// processa um acesso; index eh a posicao na sequencia (so p logs) e nextUse o proximo uso da pag
+int simAccess(Simulation* sim, uint32_t page, long long index, long long nextUse) {
+    int slot = sim->slotOf[page];
+    if (slot >= 0) {
+        if (sim->policy->onHit) sim->policy->onHit(sim->state, page, slot, nextUse);
+        return 0;
+    }
+
+    // page fault
+    sim->faults++;
+    if (sim->loads) sim->loads[page]++;
+    else if (sim->hitters) heavyHittersAdd(sim->hitters, page);
+
+    uint32_t victimPage = PAGE_NONE;
+    if (sim->usedFrames < sim->numFrames) {
+        slot = sim->usedFrames++; // ainda tem slot vazio
+    } else {
+        victimPage = sim->policy->chooseVictim(sim->state, page);
+        slot = sim->slotOf[victimPage];
+        sim->slotOf[victimPage] = -1;
+    }
+
+    // so o registro binario; o texto (e o estado dos frames no modo didatico) sai na thread de logs
+    if (sim->logSource >= 0) eventLogFault(sim->logSource, index, page, victimPage, slot);
+
+    //coloca nova pag no quadro
+    sim->frames[slot] = page;
+    sim->slotOf[page] = slot;
+    sim->policy->onMiss(sim->state, page, slot, nextUse);
+    return 1;
+}
+
+// aumenta a qtde de pags q a simulação comporta (no --stream as pags vao aparecendo durante a leitura)
+// loads, se tiver, cresce junto e pode mudar de endereço
+void simGrow(Simulation* sim, int numPages) {
+    if (numPages <= sim->numPages) return;
+    sim->slotOf = (int*)policyRealloc(sim->slotOf, sim->numPages, numPages, sizeof(int));
+    for (int i = sim->numPages; i < numPages; i++) sim->slotOf[i] = -1;
+    if (sim->loads) sim->loads = (int*)policyRealloc(sim->loads, sim->numPages, numPages, sizeof(int));
+    if (sim->policy->grow) sim->policy->grow(sim->state, sim->numPages, numPages);
+    sim->numPages = numPages;
+}
+
+void simFree(Simulation* sim) {
+    sim->policy->destroy(sim->state);
+    free(sim->frames);
+    free(sim->slotOf);
+    sim->state = NULL;
+    sim->frames = NULL;
+    sim->slotOf = NULL;
+}
+
+// roda os acessos [from, to) da sequencia (nextUse NULL = politica online)
+void simRun(Simulation* sim, const PageAccess* accessSequence, const int* nextUse, int from, int to) {
+    for (int i = from; i < to; i++) {
+        long long next = 0;
+        if (nextUse) next = (nextUse[i] == INT_MAX) ? NEXT_USE_NEVER : nextUse[i];
+        simAccess(sim, accessSequence[i].page, i, next);
+    }
+}
+
+// amostra periodica do progresso: vazao desde o inicio e tempo estimado p acabar
+static void printSample(const Simulation* sim, int done, int total, double start) {
+    double elapsed = wallClock() - start;
+    double rate = (elapsed > 0) ? done / elapsed : 0.0;
+    double eta = (rate > 0) ? (total - done) / rate : 0.0;
+    printf("[%s] processando acesso %d de %d (%.1f%%): %.0f acessos/s, %lld faltas, faltam ~%.1fs...\n",
+           sim->policy->name, done, total, 100.0 * done / total, rate, sim->faults, eta);
+}
+
+// roda uma politica sobre a sequencia inteira e retorna as faltas
+// numPages = qtde de indices densos da sequencia (g_pageCount p o trace todo)
+// loads (opcional) recebe os carregamentos por pag, ou hitters a estimativa deles; so a config principal (primary) faz logs
+long long runPolicySimulation(const ReplacementPolicy* policy, PageAccess* accessSequence, const int* nextUse, int numAccesses,
+                              int numPages, int numFrames, int* loads, HeavyHitters* hitters, int primary, RunStats* stats) {
+    double wallStart = wallClock();
+    double cpuStart = threadCpuClock();
+
+    Simulation sim;
+    simInit(&sim, policy, numFrames, numPages, loads, primary && g_verbose);
+    sim.hitters = hitters;
+
+    eventLogFlush(); // logs da simulação anterior antes do cabeçalho desta
+    if (primary) printf("\nexecutando o %s...\n", policy->name);
+
+    // o laço roda em blocos entre amostras, sem resto de divisao por acesso
+    int i = 0;
+    while (i < numAccesses) {
+        int blockEnd = (numAccesses - i > LOG_INTERVAL) ? i + LOG_INTERVAL : numAccesses;
+        simRun(&sim, accessSequence, nextUse, i, blockEnd);
+        i = blockEnd;
+        if (primary && i < numAccesses) {
+            eventLogFlush();
+            printSample(&sim, i, numAccesses, wallStart);
+        }
+    }
+
+    long long faults = sim.faults;
+    if (stats) {
+        stats->scanSteps = policy->scanSteps ? policy->scanSteps(sim.state) : 0;
+        stats->wallSeconds = wallClock() - wallStart;
+        stats->cpuSeconds = threadCpuClock() - cpuStart;
+    }
+    simFree(&sim);
+    return faults;
+}
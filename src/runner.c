@@ -0,0 +1,82 @@
+#include "simulator.h"
+#include <pthread.h>
+#include <unistd.h>
+
+// executa varias simulações (politica x tamanho de memoria) em paralelo
+// a sequencia de acessos e o nextUse sao so leitura e compartilhados; frames, presença e
+// contadores de carregamento sao privados de cada job
+// (no --multiprog cada job pode trazer a propria sequencia, ex. so os acessos de um processo)
+
+typedef struct {
+    SimJob* jobs;
+    PageAccess* accessSequence;
+    const int* nextUse;
+    int numAccesses;
+} JobQueue;
+
+static void runJob(void* context, int index) {
+    JobQueue* queue = (JobQueue*)context;
+    SimJob* job = &queue->jobs[index];
+    if (job->sequence) {
+        const int* nextUse = job->policy->needsFuture ? job->nextUse : NULL;
+        job->faults = runPolicySimulation(job->policy, job->sequence, nextUse, job->numAccesses, job->numPages,
+                                          job->numFrames, job->loads, job->hitters, job->primary, &job->stats);
+        return;
+    }
+    const int* nextUse = job->policy->needsFuture ? queue->nextUse : NULL;
+    job->faults = runPolicySimulation(job->policy, queue->accessSequence, nextUse, queue->numAccesses, g_pageCount,
+                                      job->numFrames, job->loads, job->hitters, job->primary, &job->stats);
+}
+
+typedef struct {
+    int count;
+    int next; // fila de trabalho: proximo indice livre (pego com atomico)
+    void (*task)(void* context, int index);
+    void* context;
+} WorkQueue;
+
+static void* worker(void* arg) {
+    WorkQueue* queue = (WorkQueue*)arg;
+    while (1) {
+        int index = __atomic_fetch_add(&queue->next, 1, __ATOMIC_RELAXED);
+        if (index >= queue->count) break;
+        queue->task(queue->context, index);
+    }
+    return NULL;
+}
+
+// qtde de nucleos disponiveis (padrao do --threads)
+int defaultThreadCount() {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return (cores > 0) ? (int)cores : 1;
+}
+
+// chama task(context, i) p i = 0..count-1 em ate numThreads threads e espera todas
+void parallelFor(int count, int numThreads, void (*task)(void* context, int index), void* context) {
+    WorkQueue queue = { count, 0, task, context };
+
+    if (numThreads > count) numThreads = count;
+    if (numThreads <= 1) {
+        worker(&queue); // sem threads extras, na ordem
+        return;
+    }
+
+    pthread_t* threads = (pthread_t*)malloc(numThreads * sizeof(pthread_t));
+    if (!threads) {
+        perror("falha ao alocar memoria para as threads");
+        exit(1);
+    }
+    for (int t = 0; t < numThreads; t++) {
+        if (pthread_create(&threads[t], NULL, worker, &queue) != 0) {
+            perror("falha ao criar thread de simulação");
+            exit(1);
+        }
+    }
+    for (int t = 0; t < numThreads; t++) pthread_join(threads[t], NULL);
+    free(threads);
+}
+
+void runJobs(SimJob* jobs, int numJobs, PageAccess* accessSequence, const int* nextUse, int numAccesses, int numThreads) {
+    JobQueue queue = { jobs, accessSequence, nextUse, numAccesses };
+    parallelFor(numJobs, numThreads, runJob, &queue);
+}
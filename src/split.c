@@ -0,0 +1,287 @@
+#include "simulator.h"
+
+// pools separados p instruções e dados (--split): as pags "I..." so disputam os frames do pool I e as
+// outras (dados) so os do pool D. cada pool tem a propria sequencia (indices densos proprios) e roda
+// como um job separado, entao os dois pools (e as politicas) rodam em paralelo no runJobs
+//
+// fixo: a divisao nao muda. adaptativo: a cada SPLIT_EPOCH acessos compara a utilidade marginal dos pools:
+// qtas faltas da epoca cada um evitaria com uma fatia a mais de frames contra qtas o outro ganharia com uma
+// a menos (comparar as faltas absolutas favorece a classe com mais acessos, nao a q aproveita melhor os frames).
+// as politicas tem o estado dimensionado pelos frames, entao essas contas e o pool redimensionado sao
+// refeitos e aquecidos com os ultimos acessos da propria classe (faltas do aquecimento nao contam). o
+// aquecimento nao reproduz o estado exato q a politica teria, entao as faltas do adaptativo sao aproximadas
+
+typedef struct {
+    PageAccess* seq;
+    int* nextUse;     // so se alguma politica precisar do futuro
+    int numAccesses;
+    int numPages;
+} ClassSeq;
+
+typedef struct {
+    Simulation sim;
+    int frames;
+    int pos;          // acessos da classe ja simulados
+    long long faults; // das simulações anteriores ao ultimo rebalanceamento
+    long long warm;   // faltas do aquecimento da simulação atual
+} AdaptivePool;
+
+typedef struct {
+    long long faults[2];
+    int finalFrames; // frames do pool I no fim
+    int minFrames;
+    int maxFrames;
+    double meanFrames; // media no tempo (ponderada pelos acessos)
+    int moves;
+    RunStats stats;
+} AdaptiveResult;
+
+typedef struct {
+    const ReplacementPolicy** policies;
+    const ClassSeq* classes;       // [0] = I, [1] = D
+    const unsigned char* classOf;  // classe de cada acesso da sequencia original
+    int numAccesses;
+    int numFrames;
+    int startFrames;               // frames iniciais do pool I
+    AdaptiveResult* results;
+} AdaptiveContext;
+
+static long long poolFaults(const AdaptivePool* pool) {
+    return pool->faults + pool->sim.faults - pool->warm;
+}
+
+// acessos de aquecimento antes de from p um pool com tantos frames
+static int warmupStart(int from, int frames) {
+    int warmup = (2 * frames > SPLIT_EPOCH) ? 2 * frames : SPLIT_EPOCH;
+    return (from > warmup) ? from - warmup : 0;
+}
+
+// faltas q um pool com tantos frames teria nos acessos from..to-1 da classe (aquecido antes, como no resizePool)
+static long long replayFaults(const ReplacementPolicy* policy, const ClassSeq* cls, int frames, int from, int to) {
+    Simulation sim;
+    simInit(&sim, policy, frames, cls->numPages, NULL, 0);
+    simRun(&sim, cls->seq, cls->nextUse, warmupStart(from, frames), from);
+    long long warm = sim.faults;
+    simRun(&sim, cls->seq, cls->nextUse, from, to);
+    long long faults = sim.faults - warm;
+    simFree(&sim);
+    return faults;
+}
+
+// refaz o pool com outro tamanho e reaquece com os ultimos acessos da classe
+static void resizePool(AdaptivePool* pool, const ReplacementPolicy* policy, const ClassSeq* cls, int frames) {
+    pool->faults = poolFaults(pool);
+    simFree(&pool->sim);
+    simInit(&pool->sim, policy, frames, cls->numPages, NULL, 0);
+    simRun(&pool->sim, cls->seq, cls->nextUse, warmupStart(pool->pos, frames), pool->pos);
+    pool->warm = pool->sim.faults;
+    pool->frames = frames;
+}
+
+static void adaptiveTask(void* raw, int k) {
+    AdaptiveContext* ctx = (AdaptiveContext*)raw;
+    const ReplacementPolicy* policy = ctx->policies[k];
+    AdaptiveResult* result = &ctx->results[k];
+    double wallStart = wallClock();
+    double cpuStart = threadCpuClock();
+
+    AdaptivePool pools[2];
+    memset(pools, 0, sizeof(pools));
+    pools[0].frames = ctx->startFrames;
+    pools[1].frames = ctx->numFrames - ctx->startFrames;
+    for (int c = 0; c < 2; c++) simInit(&pools[c].sim, policy, pools[c].frames, ctx->classes[c].numPages, NULL, 0);
+
+    int step = (ctx->numFrames / SPLIT_STEPS > 0) ? ctx->numFrames / SPLIT_STEPS : 1;
+    result->minFrames = result->maxFrames = pools[0].frames;
+    double frameSum = 0;
+    for (int begin = 0; begin < ctx->numAccesses; begin += SPLIT_EPOCH) {
+        int end = (ctx->numAccesses - begin > SPLIT_EPOCH) ? begin + SPLIT_EPOCH : ctx->numAccesses;
+        int count[2] = { 0, 0 };
+        for (int i = begin; i < end; i++) count[ctx->classOf[i]]++;
+
+        for (int c = 0; c < 2; c++) {
+            simRun(&pools[c].sim, ctx->classes[c].seq, ctx->classes[c].nextUse, pools[c].pos, pools[c].pos + count[c]);
+            pools[c].pos += count[c];
+        }
+        frameSum += (double)pools[0].frames * (end - begin);
+        if (end == ctx->numAccesses) break;
+
+        // utilidade marginal na epoca: gain[c] = faltas q a classe evitaria com step frames a mais,
+        // loss[c] = faltas q ela ganharia com step a menos (todas refeitas com o mesmo aquecimento)
+        long long gain[2], loss[2];
+        for (int c = 0; c < 2; c++) {
+            const ClassSeq* cls = &ctx->classes[c];
+            int from = pools[c].pos - count[c];
+            long long base = replayFaults(policy, cls, pools[c].frames, from, pools[c].pos);
+            gain[c] = base - replayFaults(policy, cls, pools[c].frames + step, from, pools[c].pos);
+            loss[c] = (pools[c].frames > step) ? replayFaults(policy, cls, pools[c].frames - step, from, pools[c].pos) - base
+                                               : LLONG_MAX;
+        }
+        // a fatia muda de pool se o q um ganha passa do q o outro perde (com 1/8 de folga, p nao trocar por ruido)
+        int to = -1;
+        if (gain[0] > 0 && loss[1] != LLONG_MAX && gain[0] > loss[1] + loss[1] / 8) to = 0;
+        else if (gain[1] > 0 && loss[0] != LLONG_MAX && gain[1] > loss[0] + loss[0] / 8) to = 1;
+        if (to < 0) continue;
+        int from = 1 - to;
+        int moved = step;
+        resizePool(&pools[from], policy, &ctx->classes[from], pools[from].frames - moved);
+        resizePool(&pools[to], policy, &ctx->classes[to], pools[to].frames + moved);
+        result->moves++;
+        if (pools[0].frames < result->minFrames) result->minFrames = pools[0].frames;
+        if (pools[0].frames > result->maxFrames) result->maxFrames = pools[0].frames;
+    }
+
+    for (int c = 0; c < 2; c++) {
+        result->faults[c] = poolFaults(&pools[c]);
+        simFree(&pools[c].sim);
+    }
+    result->finalFrames = pools[0].frames;
+    result->meanFrames = ctx->numAccesses ? frameSum / ctx->numAccesses : pools[0].frames;
+    result->stats.wallSeconds = wallClock() - wallStart;
+    result->stats.cpuSeconds = threadCpuClock() - cpuStart;
+}
+
+int runSplitPools(const Trace* trace, const ReplacementPolicy** policies, int numPolicies, int numFrames, double iShare,
+                  int adaptive, int numThreads) {
+    int numAccesses = trace->numAccesses;
+    int numPages = g_pageCount;
+    if (numFrames < 2) {
+        fprintf(stderr, "[ERRO] a memória precisa de pelo menos 2 frames para separar os pools I e D.\n");
+        return -1;
+    }
+
+    // 1) classe de cada pag (o prefixo "I" do id) e indices densos dentro da classe
+    unsigned char* pageClass = (unsigned char*)policyAlloc(numPages, sizeof(unsigned char));
+    int* localId = (int*)policyAlloc(numPages, sizeof(int));
+    ClassSeq classes[2];
+    memset(classes, 0, sizeof(classes));
+    for (int p = 0; p < numPages; p++) {
+        pageClass[p] = (pageName(p)[0] == 'I') ? 0 : 1;
+        localId[p] = classes[pageClass[p]].numPages++;
+    }
+    if (classes[0].numPages == 0 || classes[1].numPages == 0) {
+        fprintf(stderr, "[ERRO] o trace precisa ter páginas de instrução (\"I...\") e de dados para separar os pools.\n");
+        free(pageClass);
+        free(localId);
+        return -1;
+    }
+
+    // 2) sequencia de cada classe, na ordem original
+    unsigned char* classOf = (unsigned char*)policyAlloc(numAccesses, sizeof(unsigned char));
+    for (int i = 0; i < numAccesses; i++) {
+        classOf[i] = pageClass[trace->accesses[i].page];
+        classes[classOf[i]].numAccesses++;
+    }
+    for (int c = 0; c < 2; c++) classes[c].seq = (PageAccess*)policyAlloc(classes[c].numAccesses, sizeof(PageAccess));
+    int fill[2] = { 0, 0 };
+    for (int i = 0; i < numAccesses; i++) {
+        int c = classOf[i];
+        classes[c].seq[fill[c]++].page = (uint32_t)localId[trace->accesses[i].page];
+    }
+    free(localId);
+
+    int iFrames = (int)(numFrames * iShare + 0.5);
+    if (iFrames < 1) iFrames = 1;
+    if (iFrames > numFrames - 1) iFrames = numFrames - 1;
+
+    int needsFuture = 0;
+    for (int k = 0; k < numPolicies; k++) needsFuture |= policies[k]->needsFuture;
+    int* allNextUse = NULL;
+    if (needsFuture) {
+        printf("[OTIMO] pre processando a sequencia inteira e os pools I e D...\n");
+        allNextUse = computeNextUse(trace->accesses, numAccesses, numPages);
+        for (int c = 0; c < 2; c++) classes[c].nextUse = computeNextUse(classes[c].seq, classes[c].numAccesses, classes[c].numPages);
+    }
+
+    // 3) por politica: pool unico (referencia, com cargas por pag p separar as faltas por classe) + pool I + pool D
+    int numJobs = numPolicies * 3;
+    SimJob* jobs = (SimJob*)policyAlloc(numJobs, sizeof(SimJob));
+    for (int k = 0; k < numPolicies; k++) {
+        SimJob* all = &jobs[k * 3];
+        all->policy = policies[k];
+        all->numFrames = numFrames;
+        all->loads = (int*)policyAlloc(numPages, sizeof(int));
+        all->sequence = trace->accesses;
+        all->nextUse = allNextUse;
+        all->numAccesses = numAccesses;
+        all->numPages = numPages;
+        for (int c = 0; c < 2; c++) {
+            SimJob* pool = &jobs[k * 3 + 1 + c];
+            pool->policy = policies[k];
+            pool->numFrames = (c == 0) ? iFrames : numFrames - iFrames;
+            pool->sequence = classes[c].seq;
+            pool->nextUse = classes[c].nextUse;
+            pool->numAccesses = classes[c].numAccesses;
+            pool->numPages = classes[c].numPages;
+        }
+    }
+    printf("\nexecutando com pools I e D separados (%d jobs)...\n", numJobs);
+    runJobs(jobs, numJobs, NULL, NULL, 0, numThreads);
+
+    AdaptiveResult* results = NULL;
+    if (adaptive) {
+        printf("executando a divisão adaptativa (%d políticas, rebalanceando a cada %d acessos)...\n", numPolicies, SPLIT_EPOCH);
+        results = (AdaptiveResult*)policyAlloc(numPolicies, sizeof(AdaptiveResult));
+        AdaptiveContext ctx = { policies, classes, classOf, numAccesses, numFrames, iFrames, results };
+        parallelFor(numPolicies, numThreads, adaptiveTask, &ctx);
+    }
+
+    // 4) RELATÓRIO
+    printf("\nRELATÓRIO (pools I/D separados):\n");
+    printf("a memória física comporta %d páginas; divisão %s: %d para I (%.0f%%) e %d para D.\n", numFrames,
+           adaptive ? "inicial" : "fixa", iFrames, 100.0 * iFrames / numFrames, numFrames - iFrames);
+    printf("instruções: %d acessos, %d páginas distintas; dados: %d acessos, %d páginas distintas.\n",
+           classes[0].numAccesses, classes[0].numPages, classes[1].numAccesses, classes[1].numPages);
+    printf("\n%-10s %12s %12s %12s %12s %12s %12s", "política", "único I", "único D", "único", "fixo I", "fixo D", "fixo");
+    if (adaptive) printf(" %12s %12s %12s", "adapt. I", "adapt. D", "adaptativo");
+    printf("\n");
+    for (int i = 0; i < 10 + 13 * (adaptive ? 9 : 6); i++) putchar('-');
+    printf("\n");
+    for (int k = 0; k < numPolicies; k++) {
+        long long shared[2] = { 0, 0 };
+        for (int p = 0; p < numPages; p++) shared[pageClass[p]] += jobs[k * 3].loads[p];
+        long long fixedI = jobs[k * 3 + 1].faults;
+        long long fixedD = jobs[k * 3 + 2].faults;
+        printf("%-10s %12lld %12lld %12lld %12lld %12lld %12lld", policies[k]->name, shared[0], shared[1], jobs[k * 3].faults,
+               fixedI, fixedD, fixedI + fixedD);
+        if (adaptive) {
+            printf(" %12lld %12lld %12lld", results[k].faults[0], results[k].faults[1], results[k].faults[0] + results[k].faults[1]);
+        }
+        printf("\n");
+    }
+    if (adaptive) {
+        printf("\n%-10s %14s %10s %10s %10s %16s\n", "política", "frames I (fim)", "mínimo", "máximo", "médio", "rebalanceamentos");
+        for (int i = 0; i < 10 + 15 + 11 + 11 + 11 + 17; i++) putchar('-');
+        printf("\n");
+        for (int k = 0; k < numPolicies; k++) {
+            printf("%-10s %14d %10d %10d %10.1f %16d\n", policies[k]->name, results[k].finalFrames, results[k].minFrames,
+                   results[k].maxFrames, results[k].meanFrames, results[k].moves);
+        }
+    }
+
+    static const char* jobNames[] = { "pool unico", "pool I", "pool D" };
+    for (int j = 0; j < numJobs; j++) {
+        char phaseName[48];
+        snprintf(phaseName, sizeof(phaseName), "%s %s", jobs[j].policy->name, jobNames[j % 3]);
+        statsRecord(phaseName, jobs[j].stats.wallSeconds, jobs[j].stats.cpuSeconds, jobs[j].numAccesses, jobs[j].faults,
+                    jobs[j].stats.scanSteps);
+        free(jobs[j].loads);
+    }
+    for (int k = 0; adaptive && k < numPolicies; k++) {
+        char phaseName[48];
+        snprintf(phaseName, sizeof(phaseName), "%s adaptativo", policies[k]->name);
+        statsRecord(phaseName, results[k].stats.wallSeconds, results[k].stats.cpuSeconds, numAccesses,
+                    results[k].faults[0] + results[k].faults[1], 0);
+    }
+
+    free(results);
+    free(jobs);
+    free(allNextUse);
+    for (int c = 0; c < 2; c++) {
+        free(classes[c].seq);
+        free(classes[c].nextUse);
+    }
+    free(classOf);
+    free(pageClass);
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "simulator.h"
+#include <time.h>
+#include <sys/resource.h>
+
+// --stats: tempos de parede/cpu por fase e contadores dos caminhos quentes
+// as fases sao registradas pelo main depois de cada etapa; os contadores so andam com g_stats ligado
+
+#define MAX_STAT_PHASES 64
+
+int g_stats = 0;
+StatCounters g_counters;
+
+typedef struct {
+    char name[48];
+    double wallSeconds;
+    double cpuSeconds;
+    long long items;     // acessos processados na fase
+    long long faults;    // -1 = fase sem simulação
+    long long scanSteps;
+} StatPhase;
+
+static StatPhase phases[MAX_STAT_PHASES];
+static int numPhases = 0;
+
+static double readClock(clockid_t id) {
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+double wallClock() {
+    return readClock(CLOCK_MONOTONIC);
+}
+
+double cpuClock() {
+    return readClock(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+double threadCpuClock() {
+    return readClock(CLOCK_THREAD_CPUTIME_ID);
+}
+
+// uma busca na tabela de paginas que visitou length slots (counters = os da propria tabela)
+void statsProbe(StatCounters* counters, int length) {
+    counters->lookups++;
+    counters->probes += length;
+    if (length > counters->maxProbe) counters->maxProbe = length;
+}
+
+void statsRecord(const char* name, double wallSeconds, double cpuSeconds, long long items, long long faults, long long scanSteps) {
+    if (numPhases >= MAX_STAT_PHASES) return;
+    StatPhase* phase = &phases[numPhases++];
+    snprintf(phase->name, sizeof(phase->name), "%s", name);
+    phase->wallSeconds = wallSeconds;
+    phase->cpuSeconds = cpuSeconds;
+    phase->items = items;
+    phase->faults = faults;
+    phase->scanSteps = scanSteps;
+}
+
+void printStats() {
+    printf("\nESTATÍSTICAS:\n");
+    printf("%-24s %10s %10s %14s %14s %12s\n", "fase", "parede(s)", "cpu(s)", "acessos/s", "faltas/s", "varr/falta");
+    for (int i = 0; i < 24 + 11 + 11 + 15 + 15 + 13; i++) putchar('-');
+    printf("\n");
+
+    for (int i = 0; i < numPhases; i++) {
+        StatPhase* phase = &phases[i];
+        double wall = (phase->wallSeconds > 0) ? phase->wallSeconds : 1e-9;
+        printf("%-24s %10.3f %10.3f", phase->name, phase->wallSeconds, phase->cpuSeconds);
+        if (phase->items > 0) printf(" %14.0f", phase->items / wall);
+        else printf(" %14s", "-");
+        if (phase->faults >= 0) {
+            printf(" %14.0f", phase->faults / wall);
+            if (phase->faults > 0) printf(" %12.2f", (double)phase->scanSteps / phase->faults);
+            else printf(" %12s", "-");
+        } else {
+            printf(" %14s %12s", "-", "-");
+        }
+        printf("\n");
+    }
+
+    double avgProbe = (g_counters.lookups > 0) ? (double)g_counters.probes / g_counters.lookups : 0.0;
+    printf("\ntabela de páginas: %lld buscas, sondagem média %.3f, máxima %d, ocupação %d/%u (%.1f%%).\n",
+           g_counters.lookups, avgProbe, g_counters.maxProbe, g_pageCount, g_counters.tableCapacity,
+           g_counters.tableCapacity ? 100.0 * g_pageCount / g_counters.tableCapacity : 0.0);
+    if (g_counters.registerCalls > 0) {
+        printf("registerPage: %lld chamadas, %.3f s (%.1f ns por chamada).\n", g_counters.registerCalls,
+               g_counters.registerSeconds, g_counters.registerSeconds * 1e9 / g_counters.registerCalls);
+    }
+    printf("alocações: arena %zu pedidos em %zu blocos, politicas %lld callocs.\n",
+           g_arena.allocations, g_arena.chunks, g_counters.policyAllocs);
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        printf("pico de memória residente: %ld KB.\n", usage.ru_maxrss);
+    }
+}
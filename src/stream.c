@@ -0,0 +1,360 @@
+#include "simulator.h"
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// modo streaming: le o trace em blocos e alimenta todas as simulações online bloco a bloco
+// a sequencia de acessos nunca fica inteira na memoria; so os frames e os vetores por pag distinta,
+// que crescem (simGrow) conforme pags novas aparecem na leitura
+//
+// a leitura (read, parse do formato e registro das pags) roda numa thread propria e passa blocos prontos
+// p a thread das simulações por uma fila circular sem trava (um produtor, um consumidor): com o tracer
+// escrevendo num pipe, ler e simular andam juntos
+//
+// com o otimo (precisa do futuro) o trace passa antes por dois arquivos temporarios:
+// 1) os indices densos em ordem, 2) o proximo uso de cada acesso, calculado de tras pra frente em blocos
+// e a simulação le os dois juntos do inicio, sempre em blocos grandes e sequenciais
+
+#define PIPELINE_SLOTS 4 // blocos em transito entre a leitura e as simulações (potencia de 2)
+
+typedef struct {
+    PageAccess* accesses;
+    int count;     // 0 = fim do trace, -1 = erro de leitura (errno em error)
+    int pageCount; // g_pageCount qdo o bloco ficou pronto: as simulações nao leem o global, q a leitura altera
+    int error;
+} PipelineSlot;
+
+typedef struct {
+    // head e tail em linhas de cache separadas, como nos aneis do eventlog.c
+    uint32_t tail; // proximo slot q a leitura preenche
+    char padTail[60];
+    uint32_t head; // proximo slot q as simulações consomem
+    char padHead[60];
+    PipelineSlot slots[PIPELINE_SLOTS];
+    TraceReader* reader;
+    int slotAccesses;
+    int threaded;  // 0 = le na thread das simulações (os logs formatam com os nomes das pags q a leitura registra)
+    int stopping;  // pedido de parada p a leitura
+    int done;      // a leitura saiu do laço
+    pthread_t thread;
+} Pipeline;
+
+typedef struct {
+    Simulation* sims;
+    SimJob* jobs;
+    int numJobs;
+    int capacity;        // pags q as simulações comportam hoje
+    int pageCount;       // pags registradas ate o ultimo bloco entregue
+    long long total;     // acessos ja simulados
+    long long reportEvery;  // relatorio parcial a cada tantos acessos (0 = por tempo)
+    double reportSeconds;   // ou a cada tantos segundos
+    long long nextReport;
+    double nextReportTime;
+    double start;
+} StreamState;
+
+static void fillSlot(Pipeline* pipe, PipelineSlot* slot) {
+    slot->count = traceReaderNext(pipe->reader, slot->accesses, pipe->slotAccesses);
+    slot->error = errno;
+    slot->pageCount = g_pageCount;
+}
+
+static void* pipelineLoop(void* arg) {
+    Pipeline* pipe = (Pipeline*)arg;
+    while (!__atomic_load_n(&pipe->stopping, __ATOMIC_ACQUIRE)) {
+        uint32_t tail = pipe->tail;
+        if (tail - __atomic_load_n(&pipe->head, __ATOMIC_ACQUIRE) >= PIPELINE_SLOTS) {
+            usleep(50); // simulações atrasadas: todos os slots cheios
+            continue;
+        }
+        PipelineSlot* slot = &pipe->slots[tail & (PIPELINE_SLOTS - 1)];
+        fillSlot(pipe, slot);
+        __atomic_store_n(&pipe->tail, tail + 1, __ATOMIC_RELEASE);
+        if (slot->count <= 0) break; // fim ou erro: o slot avisa as simulações
+    }
+    __atomic_store_n(&pipe->done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void pipelineStart(Pipeline* pipe, TraceReader* reader, int slotAccesses) {
+    memset(pipe, 0, sizeof(*pipe));
+    pipe->reader = reader;
+    pipe->slotAccesses = slotAccesses;
+    pipe->threaded = !eventLogActive();
+    for (int s = 0; s < (pipe->threaded ? PIPELINE_SLOTS : 1); s++) {
+        pipe->slots[s].accesses = (PageAccess*)policyAlloc(slotAccesses, sizeof(PageAccess));
+    }
+    if (pipe->threaded && pthread_create(&pipe->thread, NULL, pipelineLoop, pipe) != 0) {
+        perror("falha ao criar a thread de leitura");
+        exit(1);
+    }
+}
+
+// proximo bloco (count 0 = fim, -1 = erro, com o errno); fica valido ate o pipelineRelease
+static PipelineSlot* pipelineNext(Pipeline* pipe) {
+    PipelineSlot* slot = &pipe->slots[0];
+    if (pipe->threaded) {
+        uint32_t head = pipe->head;
+        while (__atomic_load_n(&pipe->tail, __ATOMIC_ACQUIRE) == head) usleep(50);
+        slot = &pipe->slots[head & (PIPELINE_SLOTS - 1)];
+    } else {
+        fillSlot(pipe, slot);
+    }
+    errno = slot->error;
+    return slot;
+}
+
+static void pipelineRelease(Pipeline* pipe) {
+    if (pipe->threaded) __atomic_store_n(&pipe->head, pipe->head + 1, __ATOMIC_RELEASE);
+}
+
+// para a leitura (no fim ou antes, num erro de quem consome) e libera os blocos
+static void pipelineStop(Pipeline* pipe) {
+    if (pipe->threaded) {
+        __atomic_store_n(&pipe->stopping, 1, __ATOMIC_RELEASE);
+        // descarta o q ainda estiver na fila p a leitura nao ficar esperando slot livre
+        while (!__atomic_load_n(&pipe->done, __ATOMIC_ACQUIRE)) {
+            if (__atomic_load_n(&pipe->tail, __ATOMIC_ACQUIRE) != pipe->head) pipelineRelease(pipe);
+            else usleep(50);
+        }
+        pthread_join(pipe->thread, NULL);
+    }
+    for (int s = 0; s < PIPELINE_SLOTS; s++) free(pipe->slots[s].accesses);
+}
+
+// relatorio parcial: faltas acumuladas das politicas da config principal ate aqui
+static void streamReport(StreamState* stream) {
+    double elapsed = wallClock() - stream->start;
+    printf("[stream] %lld acessos simulados, %d páginas distintas, %.0f acessos/s", stream->total, stream->pageCount,
+           (elapsed > 0) ? stream->total / elapsed : 0.0);
+    for (int j = 0; j < stream->numJobs; j++) {
+        if (!stream->jobs[j].primary) continue;
+        long long faults = stream->sims[j].faults;
+        printf(" | %s: %lld faltas (%.2f%%)", stream->jobs[j].policy->name, faults,
+               (stream->total > 0) ? 100.0 * faults / stream->total : 0.0);
+    }
+    printf("\n");
+    fflush(stdout); // com o stdout num pipe/arquivo o relatorio sai na hora, nao so no fim
+}
+
+// roda um pedaço do bloco em todas as simulações
+static void feedPart(StreamState* stream, const PageAccess* part, const long long* nextUse, int count) {
+    for (int j = 0; j < stream->numJobs; j++) {
+        Simulation* sim = &stream->sims[j];
+        const long long* next = sim->policy->needsFuture ? nextUse : NULL;
+        double wallStart = wallClock();
+        double cpuStart = threadCpuClock();
+        for (int i = 0; i < count; i++) simAccess(sim, part[i].page, stream->total + i, next ? next[i] : 0);
+        stream->jobs[j].stats.wallSeconds += wallClock() - wallStart;
+        stream->jobs[j].stats.cpuSeconds += threadCpuClock() - cpuStart;
+        // logs na ordem das simulações e antes da leitura registrar pags novas (o texto usa os nomes)
+        eventLogFlush();
+    }
+    stream->total += count;
+}
+
+// entrega um bloco a todas as simulações (nextUse NULL = so politicas online)
+// pageCount = pags registradas ate o fim do bloco
+static void feedChunk(StreamState* stream, const PageAccess* chunk, const long long* nextUse, int count, int pageCount) {
+    if (pageCount > stream->capacity) {
+        while (stream->capacity < pageCount) stream->capacity *= 2;
+        for (int j = 0; j < stream->numJobs; j++) simGrow(&stream->sims[j], stream->capacity);
+    }
+
+    if (stream->reportEvery == 0) {
+        stream->pageCount = pageCount;
+        feedPart(stream, chunk, nextUse, count);
+        if (wallClock() >= stream->nextReportTime) {
+            streamReport(stream);
+            stream->nextReportTime = wallClock() + stream->reportSeconds;
+        }
+        return;
+    }
+
+    // --report-every=N: corta o bloco no proximo multiplo de N p o relatorio sair no acesso exato
+    int done = 0;
+    while (done < count) {
+        int part = count - done;
+        if (stream->nextReport - stream->total < part) part = (int)(stream->nextReport - stream->total);
+        feedPart(stream, chunk + done, nextUse ? nextUse + done : NULL, part);
+        // indices densos saem na ordem da 1a aparicao, entao as pags vistas ate aqui sao o maior indice + 1
+        for (int i = done; i < done + part; i++) {
+            if ((int)chunk[i].page >= stream->pageCount) stream->pageCount = (int)chunk[i].page + 1;
+        }
+        done += part;
+        if (stream->total == stream->nextReport) {
+            streamReport(stream);
+            stream->nextReport += stream->reportEvery;
+        }
+    }
+    stream->pageCount = pageCount;
+}
+
+static long long streamOnline(StreamState* stream, TraceReader* reader) {
+    Pipeline pipe;
+    pipelineStart(&pipe, reader, STREAM_CHUNK_ACCESSES);
+    int count;
+    while (1) {
+        PipelineSlot* slot = pipelineNext(&pipe);
+        count = slot->count;
+        if (count > 0) feedChunk(stream, slot->accesses, NULL, count, slot->pageCount);
+        pipelineRelease(&pipe);
+        if (count <= 0) break;
+    }
+    int error = errno;
+    pipelineStop(&pipe);
+    errno = error;
+    return (count < 0) ? -1 : stream->total;
+}
+
+// arquivo temporario ja desvinculado do diretorio (some sozinho no close); respeita o TMPDIR
+static int openTempFile() {
+    const char* dir = getenv("TMPDIR");
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/memsim-XXXXXX", (dir && *dir) ? dir : "/tmp");
+    int fd = mkstemp(path);
+    if (fd >= 0) unlink(path);
+    return fd;
+}
+
+// pread/pwrite de um bloco inteiro (0 = ok)
+static int readBlock(int fd, void* buffer, size_t size, off_t offset) {
+    char* p = (char*)buffer;
+    while (size > 0) {
+        ssize_t done = pread(fd, p, size, offset);
+        if (done < 0 && errno == EINTR) continue;
+        if (done <= 0) return -1;
+        p += done;
+        size -= done;
+        offset += done;
+    }
+    return 0;
+}
+
+static int writeBlock(int fd, const void* buffer, size_t size, off_t offset) {
+    const char* p = (const char*)buffer;
+    while (size > 0) {
+        ssize_t done = pwrite(fd, p, size, offset);
+        if (done < 0 && errno == EINTR) continue;
+        if (done <= 0) return -1;
+        p += done;
+        size -= done;
+        offset += done;
+    }
+    return 0;
+}
+
+static long long streamWithFuture(StreamState* stream, TraceReader* reader) {
+    int pagesFd = openTempFile();
+    int indexFd = openTempFile();
+    if (pagesFd < 0 || indexFd < 0) {
+        int error = errno;
+        perror("falha ao criar os arquivos temporarios do otimo (veja o TMPDIR)");
+        if (pagesFd >= 0) close(pagesFd);
+        if (indexFd >= 0) close(indexFd);
+        errno = error;
+        return -1;
+    }
+
+    PageAccess* chunk = (PageAccess*)policyAlloc(EXTERNAL_BLOCK_ACCESSES, sizeof(PageAccess));
+    long long* nextUse = (long long*)policyAlloc(EXTERNAL_BLOCK_ACCESSES, sizeof(long long));
+    long long* lastSeen = NULL;
+    long long total = 0;
+    long long result = -1;
+    int count;
+
+    // 1) le o trace uma vez, internando as pags, e grava os indices densos em ordem
+    // (a thread de leitura ja prepara o proximo bloco enquanto este eh gravado)
+    printf("[OTIMO] gravando a sequencia de acessos em arquivo temporario...\n");
+    Pipeline pipe;
+    pipelineStart(&pipe, reader, EXTERNAL_BLOCK_ACCESSES);
+    int failed = 0;
+    while (!failed) {
+        PipelineSlot* slot = pipelineNext(&pipe);
+        count = slot->count;
+        if (count > 0) failed = writeBlock(pagesFd, slot->accesses, count * sizeof(PageAccess), total * sizeof(PageAccess)) != 0;
+        pipelineRelease(&pipe);
+        if (count <= 0) break;
+        total += count;
+    }
+    int error = errno;
+    pipelineStop(&pipe);
+    errno = error;
+    if (failed || count < 0) goto done;
+    int pageCount = g_pageCount; // a leitura acabou, o global nao muda mais
+
+    // 2) passada de tras pra frente, bloco a bloco: so o ultimo uso visto de cada pag fica na memoria
+    printf("[OTIMO] iniciando pre processamento fora da memoria (%lld acessos)...\n", total);
+    lastSeen = (long long*)policyAlloc(g_pageCount, sizeof(long long));
+    for (int p = 0; p < g_pageCount; p++) lastSeen[p] = NEXT_USE_NEVER;
+    for (long long end = total; end > 0; end -= count) {
+        count = (end > EXTERNAL_BLOCK_ACCESSES) ? EXTERNAL_BLOCK_ACCESSES : (int)end;
+        long long begin = end - count;
+        if (readBlock(pagesFd, chunk, count * sizeof(PageAccess), begin * sizeof(PageAccess)) != 0) goto done;
+        for (int i = count - 1; i >= 0; i--) {
+            uint32_t page = chunk[i].page;
+            nextUse[i] = lastSeen[page];
+            lastSeen[page] = begin + i;
+        }
+        if (writeBlock(indexFd, nextUse, count * sizeof(long long), begin * sizeof(long long)) != 0) goto done;
+    }
+    printf("[OTIMO] pre processamento concluido!\n");
+
+    // 3) simulação: acessos e proximos usos lidos juntos, do inicio
+    for (long long begin = 0; begin < total; begin += count) {
+        count = (total - begin > EXTERNAL_BLOCK_ACCESSES) ? EXTERNAL_BLOCK_ACCESSES : (int)(total - begin);
+        if (readBlock(pagesFd, chunk, count * sizeof(PageAccess), begin * sizeof(PageAccess)) != 0 ||
+            readBlock(indexFd, nextUse, count * sizeof(long long), begin * sizeof(long long)) != 0) goto done;
+        feedChunk(stream, chunk, nextUse, count, pageCount);
+    }
+    result = total;
+
+done:
+    if (result < 0 && count >= 0) perror("falha de E/S nos arquivos temporarios do otimo");
+    close(pagesFd);
+    close(indexFd);
+    free(chunk);
+    free(nextUse);
+    free(lastSeen);
+    return result;
+}
+
+long long runStreamJobs(const char* filename, SimJob* jobs, int numJobs, long long reportEvery, double reportSeconds) {
+    // comeca com o tamanho dos loads alocados pelo main e dobra qdo precisa
+    // (antes de abrir o arquivo: o dicionario do .mtr ja registra pags na abertura)
+    StreamState stream = { NULL, jobs, numJobs, (g_pageCount > 0) ? g_pageCount : 1, 0, 0, reportEvery, reportSeconds, reportEvery, 0, 0 };
+    stream.sims = (Simulation*)policyAlloc(numJobs, sizeof(Simulation));
+    int needsFuture = 0;
+    for (int j = 0; j < numJobs; j++) {
+        simInit(&stream.sims[j], jobs[j].policy, jobs[j].numFrames, stream.capacity, jobs[j].loads, jobs[j].primary && g_verbose);
+        stream.sims[j].hitters = jobs[j].hitters;
+        needsFuture |= jobs[j].policy->needsFuture;
+    }
+
+    long long total = -1;
+    TraceReader reader;
+    if (traceReaderOpen(&reader, filename, 1.0) == 0) {
+        printf("\nexecutando em streaming:");
+        for (int j = 0; j < numJobs; j++) {
+            if (jobs[j].primary) printf(" %s", jobs[j].policy->name);
+        }
+        printf("...\n");
+
+        stream.start = wallClock();
+        stream.nextReportTime = stream.start + reportSeconds;
+        total = needsFuture ? streamWithFuture(&stream, &reader) : streamOnline(&stream, &reader);
+    }
+    int savedErrno = errno; // o erro da leitura, nao o da limpeza
+    traceReaderClose(&reader);
+
+    for (int j = 0; j < numJobs; j++) {
+        Simulation* sim = &stream.sims[j];
+        jobs[j].faults = sim->faults;
+        jobs[j].loads = sim->loads; // pode ter sido realocado pelo simGrow
+        jobs[j].stats.scanSteps = sim->policy->scanSteps ? sim->policy->scanSteps(sim->state) : 0;
+        simFree(sim);
+    }
+    free(stream.sims);
+    errno = savedErrno;
+    return total;
+}
@@ -0,0 +1,193 @@
+#include "simulator.h"
+
+// custo de tradução (--tlb): TLB associativa por conjunto + page walk numa tabela de 2, 3 ou 4 niveis
+// roda sobre a mesma sequencia de acessos das politicas, independente delas (a TLB so guarda traduções)
+//
+// o id da pag vira um numero de pag virtual (vpn): o numero no fim do id ("D2513" -> 2513) e o prefixo
+// ("I", "D", ...) escolhe uma regiao separada do espaço de endereçamento, como codigo e dados num processo
+// tudo em vetores planos: as vias de um conjunto ficam lado a lado na memoria
+
+#define VIRTUAL_BITS 48            // espaço virtual do x86-64; a vpn tem 48 - log2(tam da pag) bits
+#define MAX_VPN_REGIONS 256        // o prefixo ocupa os 8 bits de cima da vpn
+#define TLB_WALK_CACHE_ENTRIES 32  // cache de entradas dos niveis de cima (paging-structure cache), por nivel
+
+typedef struct {
+    uint64_t* tags;   // sets * ways, vpn + 1 (0 = entrada vazia)
+    uint64_t* stamps; // ultimo uso (lru) ou chegada (fifo)
+    int sets;
+    int ways;
+    uint64_t clock;
+    uint32_t random;  // xorshift p a substituição aleatoria
+} Tlb;
+
+static int compareUint64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static int vpnBits() {
+    return VIRTUAL_BITS - 12 - pageSizeShift(g_pageSize);
+}
+
+// vpn de cada pag distinta (indice denso -> vpn)
+static uint64_t* buildVpnTable() {
+    char regions[MAX_VPN_REGIONS][MAX_PAGE_ID_LEN];
+    int numRegions = 0;
+    int regionShift = vpnBits() - 8;
+    uint64_t* vpnOf = (uint64_t*)policyAlloc(g_pageCount, sizeof(uint64_t));
+
+    for (int p = 0; p < g_pageCount; p++) {
+        const char* id = pageName(p);
+        size_t digits;
+        uint64_t number;
+        if (!splitPageId(id, &digits, &number)) {
+            // id sem numero: usa o indice denso numa regiao propria
+            vpnOf[p] = ((uint64_t)(MAX_VPN_REGIONS - 1) << regionShift) | ((uint64_t)p & ((1ULL << regionShift) - 1));
+            continue;
+        }
+
+        int region = 0;
+        while (region < numRegions && (strlen(regions[region]) != digits || strncmp(regions[region], id, digits) != 0)) region++;
+        if (region == numRegions && numRegions < MAX_VPN_REGIONS - 1) {
+            memcpy(regions[numRegions], id, digits);
+            regions[numRegions][digits] = '\0';
+            numRegions++;
+        }
+        if (region > MAX_VPN_REGIONS - 2) region = MAX_VPN_REGIONS - 2; // prefixos demais dividem a ultima
+        vpnOf[p] = ((uint64_t)region << regionShift) | (number & ((1ULL << regionShift) - 1));
+    }
+    return vpnOf;
+}
+
+// procura a tradução; se nao achar, instala no lugar da vitima do conjunto. 1 = acerto
+static int tlbLookup(Tlb* tlb, uint64_t vpn, int replacement) {
+    uint64_t tag = vpn + 1;
+    int base = (int)(vpn & (tlb->sets - 1)) * tlb->ways;
+    uint64_t* tags = tlb->tags + base;
+    uint64_t* stamps = tlb->stamps + base;
+    tlb->clock++;
+
+    int victim = 0;
+    for (int w = 0; w < tlb->ways; w++) {
+        if (tags[w] == tag) {
+            if (replacement == TLB_LRU) stamps[w] = tlb->clock;
+            return 1;
+        }
+        if (stamps[w] < stamps[victim]) victim = w; // vazia tem stamp 0, entao eh escolhida antes
+    }
+
+    if (replacement == TLB_RANDOM && tags[tlb->ways - 1] != 0) {
+        tlb->random ^= tlb->random << 13;
+        tlb->random ^= tlb->random >> 17;
+        tlb->random ^= tlb->random << 5;
+        victim = tlb->random % tlb->ways;
+    }
+    tags[victim] = tag;
+    stamps[victim] = tlb->clock;
+    return 0;
+}
+
+// 3 formas: "64" (totalmente associativa), "64x4" (4 vias), "64x4,fifo"; 0 = ok
+int parseTlbConfig(const char* text, TlbConfig* config) {
+    char* end;
+    config->entries = (int)strtol(text, &end, 10);
+    config->ways = config->entries;
+    config->replacement = TLB_LRU;
+    if (*end == 'x') config->ways = (int)strtol(end + 1, &end, 10);
+    if (*end == ',') {
+        end++;
+        if (strcmp(end, "lru") == 0) config->replacement = TLB_LRU;
+        else if (strcmp(end, "fifo") == 0) config->replacement = TLB_FIFO;
+        else if (strcmp(end, "random") == 0) config->replacement = TLB_RANDOM;
+        else return -1;
+    } else if (*end != '\0') {
+        return -1;
+    }
+
+    if (config->entries < 1 || config->ways < 1 || config->ways > config->entries || config->entries % config->ways != 0) return -1;
+    int sets = config->entries / config->ways;
+    return ((sets & (sets - 1)) == 0) ? 0 : -1; // conjunto escolhido pelos bits baixos da vpn
+}
+
+// TLB + page walk sobre a sequencia inteira e os nos q uma tabela de config->levels niveis ocuparia
+void runTlbSimulation(const PageAccess* accessSequence, int numAccesses, const TlbConfig* config, TlbResult* result) {
+    int levels = config->levels;
+    int bitsPerLevel = (vpnBits() + levels - 1) / levels;
+    memset(result, 0, sizeof(*result));
+
+    uint64_t* vpnOf = buildVpnTable();
+    Tlb tlb;
+    tlb.ways = config->ways;
+    tlb.sets = config->entries / config->ways;
+    tlb.tags = (uint64_t*)policyAlloc(config->entries, sizeof(uint64_t));
+    tlb.stamps = (uint64_t*)policyAlloc(config->entries, sizeof(uint64_t));
+    tlb.clock = 0;
+    tlb.random = 2463534242u;
+
+    // cache dos niveis de cima, mapeamento direto: walkCache[nivel][i] = prefixo da vpn + 1
+    // o walk comeca no nivel mais fundo cujo prefixo ta em cache (no maximo so a folha)
+    uint64_t walkCache[MAX_PAGE_TABLE_LEVELS - 1][TLB_WALK_CACHE_ENTRIES];
+    memset(walkCache, 0, sizeof(walkCache));
+    int shiftOf[MAX_PAGE_TABLE_LEVELS]; // bits abaixo do prefixo q identifica a entrada do nivel
+    for (int l = 0; l < levels; l++) shiftOf[l] = bitsPerLevel * (levels - 1 - l);
+
+    for (int i = 0; i < numAccesses; i++) {
+        uint64_t vpn = vpnOf[accessSequence[i].page];
+        if (tlbLookup(&tlb, vpn, config->replacement)) {
+            result->hits++;
+            continue;
+        }
+
+        // page walk: referencias a memoria = niveis abaixo do prefixo mais fundo em cache
+        int depth = levels;
+        for (int l = levels - 2; l >= 0; l--) {
+            uint64_t prefix = vpn >> shiftOf[l];
+            if (walkCache[l][prefix & (TLB_WALK_CACHE_ENTRIES - 1)] == prefix + 1) {
+                depth = levels - 1 - l;
+                break;
+            }
+        }
+        for (int l = 0; l < levels - 1; l++) {
+            uint64_t prefix = vpn >> shiftOf[l];
+            walkCache[l][prefix & (TLB_WALK_CACHE_ENTRIES - 1)] = prefix + 1;
+        }
+        result->walks++;
+        result->walkReferences += depth;
+    }
+    result->accesses = numAccesses;
+
+    // nos da tabela: prefixos distintos das vpns em cada nivel (ordenadas, prefixos iguais ficam juntos)
+    qsort(vpnOf, g_pageCount, sizeof(uint64_t), compareUint64);
+    for (int l = 0; l < levels; l++) {
+        int shift = bitsPerLevel * (levels - l);
+        long long nodes = 1; // a raiz existe mesmo sem pags
+        for (int p = 1; p < g_pageCount; p++) {
+            if ((vpnOf[p] >> shift) != (vpnOf[p - 1] >> shift)) nodes++;
+        }
+        result->nodes[l] = nodes;
+        result->tableBytes += nodes * ((long long)8 << bitsPerLevel);
+    }
+
+    free(vpnOf);
+    free(tlb.tags);
+    free(tlb.stamps);
+}
+
+void printTlbReport(const TlbConfig* config, const TlbResult* result) {
+    static const char* replacementNames[] = { "lru", "fifo", "random" };
+    int levels = config->levels;
+    int bitsPerLevel = (vpnBits() + levels - 1) / levels;
+
+    printf("\nTRADUÇÃO DE ENDEREÇOS:\n");
+    printf("TLB de %d entradas, %d vias (%d conjuntos), substituição %s.\n", config->entries, config->ways,
+           config->entries / config->ways, replacementNames[config->replacement]);
+    printf("acertos na TLB: %lld de %lld acessos (%.2f%%).\n", result->hits, result->accesses,
+           result->accesses ? 100.0 * result->hits / result->accesses : 0.0);
+    printf("page walks: %lld, profundidade média %.2f de %d níveis (%lld referências à memória).\n", result->walks,
+           result->walks ? (double)result->walkReferences / result->walks : 0.0, levels, result->walkReferences);
+
+    printf("tabela de páginas em %d níveis (%d bits por nível): nós por nível", levels, bitsPerLevel);
+    for (int l = 0; l < levels; l++) printf("%s%lld", l ? "/" : " ", result->nodes[l]);
+    printf(", %lld bytes (%.2f KB).\n", result->tableBytes, result->tableBytes / 1024.0);
+}
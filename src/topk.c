@@ -0,0 +1,409 @@
+#include "simulator.h"
+
+// --top: as K pags mais recarregadas de cada politica e as de maior diferença p o otimo
+// exato: usa os carregamentos por pag dos jobs principais (um int por pag por politica)
+// aproximado: memoria fixa, q nao depende de qtas pags o trace tem
+//   space-saving (contadores em heap de minimo): guarda as candidatas a mais recarregadas; a contagem
+//   de cada uma passa da real em no maximo o erro guardado junto
+//   count-min: estimativa das cargas de qq pag (usado p as cargas do otimo na diferença), erro <= e * total / largura
+
+#define CM_DEPTH 4
+
+static uint32_t mix32(uint32_t value) {
+    value ^= value >> 16;
+    value *= 0x85ebca6b;
+    value ^= value >> 13;
+    value *= 0xc2b2ae35;
+    value ^= value >> 16;
+    return value;
+}
+
+static uint32_t roundPow2(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+HeavyHitters* heavyHittersCreate(int counters) {
+    HeavyHitters* hitters = (HeavyHitters*)policyAlloc(1, sizeof(HeavyHitters));
+    hitters->capacity = counters;
+    hitters->pages = (uint32_t*)policyAlloc(counters, sizeof(uint32_t));
+    hitters->counts = (long long*)policyAlloc(counters, sizeof(long long));
+    hitters->errors = (long long*)policyAlloc(counters, sizeof(long long));
+    hitters->slotOfPos = (uint32_t*)policyAlloc(counters, sizeof(uint32_t));
+
+    // indice pag -> posicao no heap, enderecamento aberto com no maximo 50% de ocupação
+    uint32_t indexSize = roundPow2((uint32_t)counters * 2);
+    hitters->indexMask = indexSize - 1;
+    hitters->indexKeys = (uint32_t*)policyAlloc(indexSize, sizeof(uint32_t));
+    hitters->indexPos = (int*)policyAlloc(indexSize, sizeof(int));
+    for (uint32_t i = 0; i < indexSize; i++) hitters->indexKeys[i] = PAGE_NONE;
+
+    hitters->cmWidth = roundPow2((uint32_t)counters * 4);
+    hitters->cm = (long long*)policyAlloc((size_t)CM_DEPTH * hitters->cmWidth, sizeof(long long));
+    return hitters;
+}
+
+void heavyHittersFree(HeavyHitters* hitters) {
+    if (!hitters) return;
+    free(hitters->pages);
+    free(hitters->counts);
+    free(hitters->errors);
+    free(hitters->slotOfPos);
+    free(hitters->indexKeys);
+    free(hitters->indexPos);
+    free(hitters->cm);
+    free(hitters);
+}
+
+size_t heavyHittersBytes(const HeavyHitters* hitters) {
+    size_t bytes = sizeof(HeavyHitters);
+    bytes += (size_t)hitters->capacity * (sizeof(uint32_t) * 2 + sizeof(long long) * 2);
+    bytes += (size_t)(hitters->indexMask + 1) * (sizeof(uint32_t) + sizeof(int));
+    bytes += (size_t)CM_DEPTH * hitters->cmWidth * sizeof(long long);
+    return bytes;
+}
+
+static uint32_t indexFind(const HeavyHitters* hitters, uint32_t page) {
+    uint32_t slot = mix32(page) & hitters->indexMask;
+    while (hitters->indexKeys[slot] != PAGE_NONE && hitters->indexKeys[slot] != page) slot = (slot + 1) & hitters->indexMask;
+    return slot;
+}
+
+// remove sem lapide: puxa p tras as chaves seguintes do mesmo aglomerado
+static void indexRemove(HeavyHitters* hitters, uint32_t slot) {
+    uint32_t mask = hitters->indexMask;
+    uint32_t hole = slot;
+    uint32_t next = (slot + 1) & mask;
+    while (hitters->indexKeys[next] != PAGE_NONE) {
+        uint32_t home = mix32(hitters->indexKeys[next]) & mask;
+        // a chave pode ir p o buraco se a posição ideal dela nao ta entre o buraco e ela
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            hitters->indexKeys[hole] = hitters->indexKeys[next];
+            hitters->indexPos[hole] = hitters->indexPos[next];
+            hitters->slotOfPos[hitters->indexPos[hole]] = hole;
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    hitters->indexKeys[hole] = PAGE_NONE;
+}
+
+static void heapSwap(HeavyHitters* hitters, int a, int b) {
+    uint32_t page = hitters->pages[a];
+    long long count = hitters->counts[a];
+    long long error = hitters->errors[a];
+    uint32_t slot = hitters->slotOfPos[a];
+    hitters->pages[a] = hitters->pages[b];
+    hitters->counts[a] = hitters->counts[b];
+    hitters->errors[a] = hitters->errors[b];
+    hitters->slotOfPos[a] = hitters->slotOfPos[b];
+    hitters->pages[b] = page;
+    hitters->counts[b] = count;
+    hitters->errors[b] = error;
+    hitters->slotOfPos[b] = slot;
+    hitters->indexPos[hitters->slotOfPos[a]] = a;
+    hitters->indexPos[hitters->slotOfPos[b]] = b;
+}
+
+static void siftUp(HeavyHitters* hitters, int pos) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (hitters->counts[parent] <= hitters->counts[pos]) break;
+        heapSwap(hitters, parent, pos);
+        pos = parent;
+    }
+}
+
+static void siftDown(HeavyHitters* hitters, int pos) {
+    while (1) {
+        int smallest = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if (left < hitters->size && hitters->counts[left] < hitters->counts[smallest]) smallest = left;
+        if (right < hitters->size && hitters->counts[right] < hitters->counts[smallest]) smallest = right;
+        if (smallest == pos) break;
+        heapSwap(hitters, pos, smallest);
+        pos = smallest;
+    }
+}
+
+// uma carga da pag (chamado no page fault)
+void heavyHittersAdd(HeavyHitters* hitters, uint32_t page) {
+    hitters->total++;
+    for (int row = 0; row < CM_DEPTH; row++) {
+        uint32_t column = mix32(page + row * 0x9e3779b9u) & (hitters->cmWidth - 1);
+        hitters->cm[(size_t)row * hitters->cmWidth + column]++;
+    }
+
+    uint32_t slot = indexFind(hitters, page);
+    if (hitters->indexKeys[slot] == page) {
+        int pos = hitters->indexPos[slot];
+        hitters->counts[pos]++;
+        siftDown(hitters, pos);
+        return;
+    }
+
+    int pos;
+    if (hitters->size < hitters->capacity) {
+        pos = hitters->size++;
+        hitters->counts[pos] = 1;
+        hitters->errors[pos] = 0;
+    } else {
+        // substitui a de menor contagem; a nova herda essa contagem como erro
+        pos = 0;
+        indexRemove(hitters, hitters->slotOfPos[0]);
+        hitters->errors[0] = hitters->counts[0];
+        hitters->counts[0]++;
+        slot = indexFind(hitters, page); // a remoção pode ter mexido no aglomerado
+    }
+    hitters->pages[pos] = page;
+    hitters->indexKeys[slot] = page;
+    hitters->indexPos[slot] = pos;
+    hitters->slotOfPos[pos] = slot;
+    if (pos == 0 && hitters->size == hitters->capacity) siftDown(hitters, 0);
+    else siftUp(hitters, pos);
+}
+
+// estimativa do count-min (nunca menor q a real)
+long long heavyHittersQuery(const HeavyHitters* hitters, uint32_t page) {
+    long long estimate = LLONG_MAX;
+    for (int row = 0; row < CM_DEPTH; row++) {
+        uint32_t column = mix32(page + row * 0x9e3779b9u) & (hitters->cmWidth - 1);
+        long long value = hitters->cm[(size_t)row * hitters->cmWidth + column];
+        if (value < estimate) estimate = value;
+    }
+    return estimate;
+}
+
+// erro do count-min com ~98% de confiança (e * total / largura)
+static long long queryBound(const HeavyHitters* hitters) {
+    return (long long)(2.718281828 * hitters->total / hitters->cmWidth + 0.999);
+}
+
+typedef struct {
+    uint32_t page;
+    long long value;   // cargas (ou diferença)
+    long long loads;   // cargas da politica
+    long long optimal; // cargas do otimo (so na diferença)
+    long long error;
+} TopEntry;
+
+// ordem do ranking: maior valor primeiro; no empate, menor erro (mais garantida) e depois a ordem em q a pag
+// apareceu no trace
+static int ranksBefore(const TopEntry* a, const TopEntry* b) {
+    if (a->value != b->value) return a->value > b->value;
+    if (a->error != b->error) return a->error < b->error;
+    return a->page < b->page;
+}
+
+static int compareEntries(const void* a, const void* b) {
+    return ranksBefore((const TopEntry*)a, (const TopEntry*)b) ? -1 : 1;
+}
+
+// mantem as k melhores num heap de minimo (a raiz eh a pior das k)
+static void keepTop(TopEntry* top, int* size, int k, TopEntry entry) {
+    int pos;
+    if (*size < k) {
+        pos = (*size)++;
+        top[pos] = entry;
+        while (pos > 0 && ranksBefore(&top[(pos - 1) / 2], &top[pos])) {
+            TopEntry temp = top[pos];
+            top[pos] = top[(pos - 1) / 2];
+            top[(pos - 1) / 2] = temp;
+            pos = (pos - 1) / 2;
+        }
+        return;
+    }
+    if (!ranksBefore(&entry, &top[0])) return;
+    top[0] = entry;
+    pos = 0;
+    while (1) {
+        int worst = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if (left < *size && ranksBefore(&top[worst], &top[left])) worst = left;
+        if (right < *size && ranksBefore(&top[worst], &top[right])) worst = right;
+        if (worst == pos) break;
+        TopEntry temp = top[pos];
+        top[pos] = top[worst];
+        top[worst] = temp;
+        pos = worst;
+    }
+}
+
+// ranking das cargas de uma politica
+static int topLoads(const int* loads, const HeavyHitters* hitters, int numPages, int k, TopEntry* top) {
+    int size = 0;
+    if (loads) {
+        for (int p = 0; p < numPages; p++) {
+            if (loads[p] > 0) keepTop(top, &size, k, (TopEntry){ (uint32_t)p, loads[p], loads[p], 0, 0 });
+        }
+    } else {
+        for (int i = 0; i < hitters->size; i++) {
+            TopEntry entry = { hitters->pages[i], hitters->counts[i], hitters->counts[i], 0, hitters->errors[i] };
+            keepTop(top, &size, k, entry);
+        }
+    }
+    qsort(top, size, sizeof(TopEntry), compareEntries);
+    return size;
+}
+
+// ranking da diferença politica - otimo (so pags q a politica recarrega mais)
+// no aproximado as candidatas sao as do space-saving da politica e as cargas do otimo vem do count-min
+static int topGap(const int* loads, const int* optimalLoads, const HeavyHitters* hitters, const HeavyHitters* optimalHitters,
+                  int numPages, int k, TopEntry* top) {
+    int size = 0;
+    if (loads) {
+        for (int p = 0; p < numPages; p++) {
+            long long gap = (long long)loads[p] - optimalLoads[p];
+            if (gap > 0) keepTop(top, &size, k, (TopEntry){ (uint32_t)p, gap, loads[p], optimalLoads[p], 0 });
+        }
+    } else {
+        long long bound = queryBound(optimalHitters);
+        for (int i = 0; i < hitters->size; i++) {
+            long long optimal = heavyHittersQuery(optimalHitters, hitters->pages[i]);
+            long long gap = hitters->counts[i] - optimal;
+            TopEntry entry = { hitters->pages[i], gap, hitters->counts[i], optimal, hitters->errors[i] + bound };
+            if (gap > 0) keepTop(top, &size, k, entry);
+        }
+    }
+    qsort(top, size, sizeof(TopEntry), compareEntries);
+    return size;
+}
+
+// ids vem do trace (qq caractere q nao seja espaço), entao escapa
+static void writeCsvField(FILE* out, const char* text) {
+    if (!strpbrk(text, ",\"")) {
+        fputs(text, out);
+        return;
+    }
+    fputc('"', out);
+    for (; *text; text++) {
+        if (*text == '"') fputc('"', out);
+        fputc(*text, out);
+    }
+    fputc('"', out);
+}
+
+static void writeJsonString(FILE* out, const char* text) {
+    fputc('"', out);
+    for (; *text; text++) {
+        unsigned char c = (unsigned char)*text;
+        if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+        else if (c < 0x20) fprintf(out, "\\u%04x", c);
+        else fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+static void printRanking(const char* title, const TopEntry* top, int size, int gap, int approximate) {
+    printf("\n%s\n", title);
+    if (size == 0) {
+        printf("(nenhuma página)\n");
+        return;
+    }
+    printf("%-8s %-10s %-10s", "posição", "página", "cargas");
+    if (gap) printf(" %-10s %-10s", "otimo", "diferença");
+    if (approximate) printf(" %-10s", "erro");
+    printf("\n");
+    for (int i = 0; i < size; i++) {
+        printf("%-8d %-10s %-10lld", i + 1, pageName(top[i].page), top[i].loads);
+        if (gap) printf(" %-10lld %-10lld", top[i].optimal, top[i].value);
+        if (approximate) printf(" %-10lld", top[i].error);
+        printf("\n");
+    }
+}
+
+static void writeCsvRows(FILE* out, const char* kind, const char* policy, const TopEntry* top, int size, int gap) {
+    for (int i = 0; i < size; i++) {
+        fprintf(out, "%s,", kind);
+        writeCsvField(out, policy);
+        fprintf(out, ",%d,", i + 1);
+        writeCsvField(out, pageName(top[i].page));
+        fprintf(out, ",%lld,", top[i].loads);
+        if (gap) fprintf(out, "%lld,%lld", top[i].optimal, top[i].value);
+        else fprintf(out, ",");
+        fprintf(out, ",%lld\n", top[i].error);
+    }
+}
+
+static void writeJsonRows(FILE* out, const TopEntry* top, int size, int gap) {
+    fprintf(out, "[");
+    for (int i = 0; i < size; i++) {
+        fprintf(out, "%s\n      {\"pagina\": ", i ? "," : "");
+        writeJsonString(out, pageName(top[i].page));
+        fprintf(out, ", \"cargas\": %lld", top[i].loads);
+        if (gap) fprintf(out, ", \"cargas_otimo\": %lld, \"diferenca\": %lld", top[i].optimal, top[i].value);
+        fprintf(out, ", \"erro\": %lld}", top[i].error);
+    }
+    fprintf(out, size ? "\n    ]" : "]");
+}
+
+// relatorio do --top: uma coluna por politica (loads exatos ou hitters aproximados), optimalColumn -1 = sem otimo
+// outPath (opcional) recebe o mesmo ranking em csv, ou json se terminar em .json; 0 = ok
+int runTopReport(const char** names, int** loads, HeavyHitters** hitters, int numColumns, int optimalColumn, int k,
+                 int numPages, const char* outPath) {
+    int approximate = (loads[0] == NULL);
+    TopEntry* top = (TopEntry*)policyAlloc(k, sizeof(TopEntry));
+    FILE* out = NULL;
+    int json = 0;
+    if (outPath) {
+        out = fopen(outPath, "w");
+        if (!out) {
+            free(top);
+            return -1;
+        }
+        size_t len = strlen(outPath);
+        json = (len >= 5 && strcmp(outPath + len - 5, ".json") == 0);
+        if (json) fprintf(out, "{\n  \"modo\": \"%s\",\n  \"k\": %d,\n  \"cargas\": {", approximate ? "aproximado" : "exato", k);
+        else fprintf(out, "tipo,politica,posicao,pagina,cargas,cargas_otimo,diferenca,erro\n");
+    }
+
+    printf("\nPÁGINAS MAIS RECARREGADAS (%s", approximate ? "aproximado" : "exato");
+    if (approximate) {
+        printf(", %d contadores e %.1f KB por política", hitters[0]->capacity, heavyHittersBytes(hitters[0]) / 1024.0);
+    }
+    printf("):\n");
+
+    char title[96];
+    for (int c = 0; c < numColumns; c++) {
+        int size = topLoads(loads[c], hitters[c], numPages, k, top);
+        snprintf(title, sizeof(title), "top %d cargas do %s:", k, names[c]);
+        printRanking(title, top, size, 0, approximate);
+        if (out && json) {
+            fprintf(out, "%s\n    ", c ? "," : "");
+            writeJsonString(out, names[c]);
+            fprintf(out, ": ");
+            writeJsonRows(out, top, size, 0);
+        } else if (out) {
+            writeCsvRows(out, "cargas", names[c], top, size, 0);
+        }
+    }
+    if (out && json) fprintf(out, "\n  },\n  \"diferenca\": {");
+
+    int first = 1;
+    for (int c = 0; c < numColumns && optimalColumn >= 0; c++) {
+        if (c == optimalColumn) continue;
+        int size = topGap(loads[c], loads[optimalColumn], hitters[c], hitters[optimalColumn], numPages, k, top);
+        snprintf(title, sizeof(title), "top %d diferença %s - %s (recargas além do ótimo):", k, names[c], names[optimalColumn]);
+        printRanking(title, top, size, 1, approximate);
+        if (out && json) {
+            fprintf(out, "%s\n    ", first ? "" : ",");
+            writeJsonString(out, names[c]);
+            fprintf(out, ": ");
+            writeJsonRows(out, top, size, 1);
+        } else if (out) {
+            writeCsvRows(out, "diferenca", names[c], top, size, 1);
+        }
+        first = 0;
+    }
+    if (out && json) fprintf(out, first ? "}\n}\n" : "\n  }\n}\n");
+
+    free(top);
+    if (!out) return 0;
+    int failed = ferror(out);
+    if (fclose(out) != 0 || failed) return -1;
+    printf("\nranking gravado em %s.\n", outPath);
+    return 0;
+}
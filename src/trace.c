@@ -0,0 +1,660 @@
+#include "simulator.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// carregamento do arquivo de acessos
+// caminho rapido: mmap do arquivo inteiro e tokenizacao no proprio buffer, sem fgets/sscanf/strcpy
+// caminho lento (pipes etc, onde nao da p mapear): fgets linha a linha com o mesmo tokenizador
+// formato binario (.mtr): cabecalho + dicionario de ids + indices densos, carregado direto via mmap
+
+#define BINARY_MAGIC "MSIMTRC1"
+#define BINARY_VERSION 1
+#define ENCODING_RAW 0    // uint32 por acesso, mapeado direto como PageAccess
+#define ENCODING_VARINT 1 // indices em varint (LEB128), decodificados no carregamento
+
+typedef struct {
+    char magic[8];
+    uint32_t version;      // tambem serve de marcador de endianness
+    uint32_t encoding;
+    uint32_t numPages;     // entradas do dicionario (na ordem dos indices densos)
+    uint32_t reserved;
+    uint64_t numAccesses;
+    uint64_t streamBytes;  // tamanho da sequencia de acessos em bytes
+} BinaryHeader;
+
+_Static_assert(sizeof(PageAccess) == sizeof(uint32_t), "PageAccess precisa ser mapeavel direto do arquivo");
+
+// inicio da sequencia de acessos: depois do dicionario, alinhado em 4 bytes
+static size_t streamOffset(uint32_t numPages) {
+    size_t offset = sizeof(BinaryHeader) + (size_t)numPages * MAX_PAGE_ID_LEN;
+    return (offset + 3) & ~(size_t)3;
+}
+
+static int isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+int g_traceFormat = TRACE_TEXT;
+
+void traceParserInit(TraceParser* parser, int format, int pageShift) {
+    parser->format = format;
+    parser->pageShift = pageShift;
+    parser->truncated = 0;
+}
+
+// parser do programa: --format e --page-size (so as leituras q registram na tabela global usam)
+static void programParser(TraceParser* parser) {
+    traceParserInit(parser, g_traceFormat, pageSizeShift(g_pageSize));
+}
+
+// FORMATOS DE TRACERS (--format=lackey|perf): a saida do tracer entra direto (por pipe), sem converter antes
+// o endereço vira o numero da pag do tamanho simulado, em hex: 48 bits de endereço cabem nos 9 caracteres do id
+// (e por isso sem prefixo I/D: codigo e dado na mesma pag sao a mesma pag). acesso q cruza pag conta so a primeira
+
+#define ADDRESS_MASK ((1ULL << 48) - 1)
+
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// endereço em hex (com ou sem 0x); retorna onde parou (== p qdo nao tinha digito)
+static const char* parseAddress(const char* p, const char* end, uint64_t* address) {
+    if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X') && hexDigit(p[2]) >= 0) p += 2;
+    uint64_t value = 0;
+    int digit;
+    while (p < end && (digit = hexDigit(*p)) >= 0) {
+        value = (value << 4) | (uint64_t)digit;
+        p++;
+    }
+    *address = value;
+    return p;
+}
+
+static size_t addressPageId(uint64_t address, int pageShift, char* out) {
+    uint64_t page = (address & ADDRESS_MASK) >> (12 + pageShift);
+    char digits[16];
+    size_t len = 0;
+    do {
+        digits[len++] = "0123456789abcdef"[page & 15];
+        page >>= 4;
+    } while (page);
+    for (size_t i = 0; i < len; i++) out[i] = digits[len - 1 - i];
+    out[len] = '\0';
+    return len;
+}
+
+// valgrind --tool=lackey --trace-mem=yes: "I  0400d7d4,8" e " L|S|M 1ffefffa40,8" (linhas "==pid==" sao mensagens)
+static size_t parseLackeyLine(const char* p, const char* end, int pageShift, char* out) {
+    if (end - p < 2 || !(*p == 'I' || *p == 'L' || *p == 'S' || *p == 'M') || !isBlank(p[1])) return 0;
+    p += 2;
+    while (p < end && isBlank(*p)) p++;
+    uint64_t address;
+    const char* q = parseAddress(p, end, &address);
+    if (q == p || (q < end && *q != ',')) return 0;
+    return addressPageId(address, pageShift, out);
+}
+
+// perf mem record + perf script -F pid,addr: "<pid> <endereço>" (so "<endereço>" com -F addr)
+// endereço 0 eh amostra sem endereço de dado e fica de fora
+static size_t parsePerfLine(const char* p, const char* end, int pageShift, char* out, int* pid) {
+    const char* first = p;
+    while (p < end && !isBlank(*p)) p++;
+    const char* second = p;
+    while (second < end && isBlank(*second)) second++;
+    const char* addressStart = (second < end) ? second : first;
+
+    long value = 0;
+    if (addressStart == second) {
+        for (const char* c = first; c < p && *c >= '0' && *c <= '9' && value <= INT_MAX; c++) value = value * 10 + (*c - '0');
+        if (value > INT_MAX) value = INT_MAX;
+    }
+    uint64_t address;
+    const char* q = parseAddress(addressStart, end, &address);
+    if (q == addressStart || (q < end && !isBlank(*q)) || address == 0) return 0;
+    if (pid) *pid = (int)value;
+    return addressPageId(address, pageShift, out);
+}
+
+// extrai o id da pag de uma linha "<pid> <id>" ou "<id>" (mesma regra do antigo "%*d %s" / "%s"), ou no --format do tracer
+// copia o id terminado em '\0' p out e retorna o tamanho (0 = linha sem id)
+// pid (opcional) recebe o numero do inicio da linha, ou 0 qdo a linha so tem o id
+size_t parseTraceLine(TraceParser* parser, const char* line, const char* end, char* out, int* pid) {
+    const char* p = line;
+    while (p < end && isBlank(*p)) p++;
+    if (parser->format != TRACE_TEXT) {
+        if (pid) *pid = 0;
+        return (parser->format == TRACE_LACKEY) ? parseLackeyLine(p, end, parser->pageShift, out)
+                                                : parsePerfLine(p, end, parser->pageShift, out, pid);
+    }
+    const char* first = p; // inicio do primeiro token (fallback "%s")
+
+    // "%*d": sinal opcional + digitos
+    const char* q = p;
+    if (q < end && (*q == '+' || *q == '-')) q++;
+    const char* digits = q;
+    while (q < end && *q >= '0' && *q <= '9') q++;
+
+    const char* token = first;
+    int hasPid = 0;
+    if (q > digits) {
+        const char* r = q;
+        while (r < end && isBlank(*r)) r++;
+        if (r < end) {
+            token = r; // tem id depois do numero
+            hasPid = 1;
+        }
+    }
+    if (pid) {
+        long value = 0;
+        if (hasPid) {
+            for (const char* c = digits; c < q && value <= INT_MAX; c++) value = value * 10 + (*c - '0');
+            if (value > INT_MAX) value = INT_MAX; // satura como o %d
+            if (*first == '-') value = -value;
+        }
+        *pid = (int)value;
+    }
+
+    const char* tokenEnd = token;
+    while (tokenEnd < end && !isBlank(*tokenEnd)) tokenEnd++;
+
+    size_t len = tokenEnd - token;
+    if (len == 0) return 0;
+    if (len >= MAX_PAGE_ID_LEN) {
+        if (!parser->truncated) {
+            fprintf(stderr, "[aviso] ids de página com mais de %d caracteres foram truncados.\n", MAX_PAGE_ID_LEN - 1);
+            parser->truncated = 1;
+        }
+        len = MAX_PAGE_ID_LEN - 1;
+    }
+    memcpy(out, token, len);
+    out[len] = '\0';
+    return len;
+}
+
+// registra o id na tabela do trace (a global qdo o trace nao tem uma propria)
+static uint32_t tracePage(Trace* trace, const char* page_id) {
+    return trace->pages ? pageTableIntern(trace->pages, page_id) : registerPage(page_id);
+}
+
+// interna o id e guarda o acesso (ignora o marcador "..."); pids so qdo o trace guarda
+static void appendAccess(Trace* trace, const char* page_id, size_t len, int pid) {
+    if (len == 3 && memcmp(page_id, "...", 3) == 0) return;
+    if (trace->pids) trace->pids[trace->numAccesses] = pid;
+    trace->accesses[trace->numAccesses++].page = tracePage(trace, page_id);
+}
+
+static int loadMapped(int fd, size_t size, Trace* trace, int keepPids) {
+    char* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) return -1;
+    madvise(data, size, MADV_SEQUENTIAL);
+    const char* end = data + size;
+
+    // conta as linhas (memchr da libc ja eh vetorizado) p alocar o array uma vez so
+    size_t lines = 1;
+    for (const char* p = data; (p = memchr(p, '\n', end - p)) != NULL; p++) lines++;
+    if (lines > INT_MAX) {
+        fprintf(stderr, "[ERRO] arquivo com acessos demais (%zu linhas).\n", lines);
+        munmap(data, size);
+        return -1;
+    }
+
+    trace->accesses = (PageAccess*)malloc(lines * sizeof(PageAccess));
+    if (keepPids) trace->pids = (int*)malloc(lines * sizeof(int));
+    if (!trace->accesses || (keepPids && !trace->pids)) {
+        perror("falha ao alocar memoria para a sequencia de acessos");
+        exit(1);
+    }
+
+    char buffer[MAX_PAGE_ID_LEN];
+    const char* line = data;
+    int pid;
+    while (line < end) {
+        const char* newline = memchr(line, '\n', end - line);
+        const char* lineEnd = newline ? newline : end;
+        size_t len = parseTraceLine(&trace->parser, line, lineEnd, buffer, &pid);
+        if (len > 0) appendAccess(trace, buffer, len, pid);
+        line = lineEnd + 1;
+    }
+
+    munmap(data, size);
+    return 0;
+}
+
+// carrega o formato binario ja mapeado; registra o dicionario na tabela hash na ordem dos indices
+static int loadBinary(char* data, size_t size, Trace* trace) {
+    BinaryHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.version != BINARY_VERSION || header.encoding > ENCODING_VARINT || header.numAccesses > INT_MAX) {
+        fprintf(stderr, "[ERRO] trace binario com versao/codificacao nao suportada.\n");
+        return -1;
+    }
+    size_t offset = streamOffset(header.numPages);
+    if (offset > size || header.streamBytes > size - offset) {
+        fprintf(stderr, "[ERRO] trace binario truncado.\n");
+        return -1;
+    }
+
+    char name[MAX_PAGE_ID_LEN];
+    const char* dictionary = data + sizeof(BinaryHeader);
+    for (uint32_t p = 0; p < header.numPages; p++) {
+        memcpy(name, dictionary + (size_t)p * MAX_PAGE_ID_LEN, MAX_PAGE_ID_LEN);
+        name[MAX_PAGE_ID_LEN - 1] = '\0';
+        if (tracePage(trace, name) != p) {
+            fprintf(stderr, "[ERRO] dicionario do trace binario com id repetido: %s\n", name);
+            return -1;
+        }
+    }
+
+    const unsigned char* stream = (const unsigned char*)data + offset;
+    int numAccesses = (int)header.numAccesses;
+
+    if (header.encoding == ENCODING_RAW) {
+        if (header.streamBytes != (uint64_t)numAccesses * sizeof(PageAccess)) {
+            fprintf(stderr, "[ERRO] trace binario truncado.\n");
+            return -1;
+        }
+        // sem copia: os acessos sao o proprio mapeamento
+        trace->accesses = (PageAccess*)stream;
+        trace->mapping = data;
+        trace->mappingSize = size;
+    } else {
+        trace->accesses = (PageAccess*)malloc((numAccesses > 0 ? numAccesses : 1) * sizeof(PageAccess));
+        if (!trace->accesses) {
+            perror("falha ao alocar memoria para a sequencia de acessos");
+            exit(1);
+        }
+        const unsigned char* p = stream;
+        const unsigned char* end = stream + header.streamBytes;
+        for (int i = 0; i < numAccesses; i++) {
+            uint32_t value = 0;
+            int shift = 0;
+            while (p < end && (*p & 0x80) && shift < 28) {
+                value |= (uint32_t)(*p++ & 0x7f) << shift;
+                shift += 7;
+            }
+            if (p >= end) {
+                fprintf(stderr, "[ERRO] trace binario truncado.\n");
+                free(trace->accesses);
+                trace->accesses = NULL;
+                return -1;
+            }
+            value |= (uint32_t)(*p++) << shift;
+            trace->accesses[i].page = value;
+        }
+    }
+    trace->numAccesses = numAccesses;
+
+    // indice fora do dicionario quebraria os vetores por pag das simulações
+    for (int i = 0; i < numAccesses; i++) {
+        if (trace->accesses[i].page >= header.numPages) {
+            fprintf(stderr, "[ERRO] trace binario com indice de página inválido no acesso %d.\n", i);
+            if (!trace->mapping) free(trace->accesses);
+            trace->accesses = NULL;
+            trace->mapping = NULL;
+            trace->numAccesses = 0;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void loadStream(FILE* file, Trace* trace, int keepPids) {
+    int capacity = 100000;
+    trace->accesses = (PageAccess*)malloc(capacity * sizeof(PageAccess));
+    if (keepPids) trace->pids = (int*)malloc(capacity * sizeof(int));
+    char line[256];
+    char buffer[MAX_PAGE_ID_LEN];
+    int pid;
+
+    // le o arq e extrai o id das pag
+    while (fgets(line, sizeof(line), file)) {
+        if (trace->numAccesses >= capacity) {
+            capacity *= 2; // se precisar
+            trace->accesses = (PageAccess*)realloc(trace->accesses, capacity * sizeof(PageAccess));
+            if (trace->pids) trace->pids = (int*)realloc(trace->pids, capacity * sizeof(int));
+            if (!trace->accesses || (keepPids && !trace->pids)) {
+                perror("falha ao realocar a sequencia de acessos");
+                exit(1);
+            }
+        }
+        size_t len = parseTraceLine(&trace->parser, line, line + strlen(line), buffer, &pid);
+        if (len > 0) appendAccess(trace, buffer, len, pid);
+    }
+}
+
+// carrega o arquivo em trace (as pags sao registradas em pages, ou na tabela global se NULL); 0 = ok, -1 = erro
+// detecta sozinho se eh texto ou o formato binario; keepPids guarda tb o pid de cada acesso (so texto)
+// parser diz como ler as linhas do texto (o .mtr ja tem os ids prontos)
+int loadTraceInto(const char* filename, Trace* trace, int keepPids, PageTable* pages, const TraceParser* parser) {
+    trace->pages = pages;
+    traceParserInit(&trace->parser, parser->format, parser->pageShift);
+    trace->accesses = NULL;
+    trace->pids = NULL;
+    trace->numAccesses = 0;
+    trace->mapping = NULL;
+    trace->mappingSize = 0;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    int mapped = -1;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        char magic[8];
+        size_t size = (size_t)st.st_size;
+        if (size >= sizeof(BinaryHeader) && pread(fd, magic, sizeof(magic), 0) == sizeof(magic) &&
+            memcmp(magic, BINARY_MAGIC, sizeof(magic)) == 0) {
+            char* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (data == MAP_FAILED) return -1;
+            int result = loadBinary(data, size, trace);
+            if (!trace->mapping) munmap(data, size); // varint ja foi decodificado
+            if (result != 0) errno = EINVAL;
+            return result;
+        }
+
+        if (size == 0) mapped = 0; // arquivo vazio
+        else mapped = loadMapped(fd, size, trace, keepPids);
+    }
+
+    if (mapped != 0) {
+        FILE* file = fdopen(fd, "r");
+        if (!file) {
+            close(fd);
+            return -1;
+        }
+        loadStream(file, trace, keepPids);
+        fclose(file);
+    } else {
+        close(fd);
+    }
+
+    // ajusta o tam do array pra quantidade exata de acessos
+    if (trace->numAccesses > 0) {
+        PageAccess* exact = (PageAccess*)realloc(trace->accesses, trace->numAccesses * sizeof(PageAccess));
+        if (exact) trace->accesses = exact;
+        if (trace->pids) {
+            int* pids = (int*)realloc(trace->pids, trace->numAccesses * sizeof(int));
+            if (pids) trace->pids = pids;
+        }
+    }
+    return 0;
+}
+
+int loadTrace(const char* filename, Trace* trace, int keepPids) {
+    TraceParser parser;
+    programParser(&parser);
+    return loadTraceInto(filename, trace, keepPids, NULL, &parser);
+}
+
+void freeTrace(Trace* trace) {
+    if (trace->mapping) munmap(trace->mapping, trace->mappingSize);
+    else free(trace->accesses);
+    free(trace->pids);
+    trace->accesses = NULL;
+    trace->pids = NULL;
+    trace->numAccesses = 0;
+    trace->mapping = NULL;
+    trace->mappingSize = 0;
+}
+
+// LEITURA EM BLOCOS (--stream)
+// o buffer tem tamanho fixo; a parte nao consumida vai pro inicio antes de cada read
+
+// poe no buffer o q ja tiver chegado (um read com dados basta: num pipe nao espera o tracer encher o buffer)
+// retorna os bytes disponiveis (-1 = erro de leitura)
+static long readerFill(TraceReader* reader) {
+    if (reader->start > 0) {
+        memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+    }
+    while (!reader->eof && reader->end < STREAM_BUFFER_SIZE) {
+        ssize_t got = read(reader->fd, reader->buffer + reader->end, STREAM_BUFFER_SIZE - reader->end);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (got == 0) reader->eof = 1;
+        reader->end += got;
+        if (got > 0) break;
+    }
+    return (long)(reader->end - reader->start);
+}
+
+// garante ao menos count bytes no buffer (menos so no fim do arquivo)
+static int readerNeed(TraceReader* reader, size_t count) {
+    while (reader->end - reader->start < count && !reader->eof) {
+        if (readerFill(reader) < 0) return -1;
+    }
+    return 0;
+}
+
+// cabecalho e dicionario do .mtr: registra as pags na ordem dos indices, como o loadBinary
+// com amostragem so registra as pags da amostra e guarda o mapa indice do arquivo -> indice denso
+static int readerOpenBinary(TraceReader* reader) {
+    BinaryHeader header;
+    if (readerNeed(reader, sizeof(header)) != 0 || reader->end - reader->start < sizeof(header)) return -1;
+    memcpy(&header, reader->buffer + reader->start, sizeof(header));
+    reader->start += sizeof(header);
+    if (header.version != BINARY_VERSION || header.encoding > ENCODING_VARINT) {
+        fprintf(stderr, "[ERRO] trace binario com versao/codificacao nao suportada.\n");
+        return -1;
+    }
+
+    int sampling = (reader->sampleThreshold <= UINT32_MAX);
+    if (sampling) reader->remap = (uint32_t*)policyAlloc(header.numPages, sizeof(uint32_t));
+
+    char name[MAX_PAGE_ID_LEN];
+    for (uint32_t p = 0; p < header.numPages; p++) {
+        if (readerNeed(reader, MAX_PAGE_ID_LEN) != 0 || reader->end - reader->start < MAX_PAGE_ID_LEN) {
+            fprintf(stderr, "[ERRO] trace binario truncado.\n");
+            return -1;
+        }
+        memcpy(name, reader->buffer + reader->start, MAX_PAGE_ID_LEN);
+        name[MAX_PAGE_ID_LEN - 1] = '\0';
+        reader->start += MAX_PAGE_ID_LEN;
+        if (sampling && !pageSampled(name, reader->sampleThreshold)) {
+            reader->remap[p] = PAGE_NONE;
+            continue;
+        }
+        uint32_t expected = (uint32_t)g_pageCount;
+        uint32_t page = registerPage(name);
+        if (sampling) reader->remap[p] = page;
+        if (page != expected) {
+            fprintf(stderr, "[ERRO] dicionario do trace binario com id repetido: %s\n", name);
+            return -1;
+        }
+    }
+
+    size_t padding = streamOffset(header.numPages) - (sizeof(header) + (size_t)header.numPages * MAX_PAGE_ID_LEN);
+    if (readerNeed(reader, padding) != 0 || reader->end - reader->start < padding) return -1;
+    reader->start += padding;
+
+    reader->binary = 1;
+    reader->encoding = header.encoding;
+    reader->numPages = header.numPages;
+    reader->remaining = header.numAccesses;
+    return 0;
+}
+
+int traceReaderOpen(TraceReader* reader, const char* filename, double sampleRate) {
+    memset(reader, 0, sizeof(*reader));
+    programParser(&reader->parser);
+    reader->sampleThreshold = sampleThreshold(sampleRate);
+    reader->fd = (strcmp(filename, "-") == 0) ? STDIN_FILENO : open(filename, O_RDONLY);
+    if (reader->fd < 0) return -1;
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(reader->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    reader->buffer = (char*)malloc(STREAM_BUFFER_SIZE);
+    if (!reader->buffer) {
+        perror("falha ao alocar o buffer de leitura");
+        exit(1);
+    }
+
+    // texto ou .mtr decide pelo inicio do arquivo (funciona com pipe tambem)
+    if (readerNeed(reader, sizeof(BinaryHeader)) < 0) return -1;
+    if (reader->end >= sizeof(BinaryHeader) && memcmp(reader->buffer, BINARY_MAGIC, 8) == 0) {
+        if (readerOpenBinary(reader) != 0) {
+            errno = EINVAL;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int readerNextBinary(TraceReader* reader, PageAccess* out, int maxAccesses) {
+    int count = 0;
+    while (count < maxAccesses && reader->remaining > 0) {
+        // um acesso ocupa no maximo 5 bytes em varint e 4 em uint32
+        if (readerNeed(reader, 5) != 0) return -1;
+        const unsigned char* p = (const unsigned char*)reader->buffer + reader->start;
+        const unsigned char* end = (const unsigned char*)reader->buffer + reader->end;
+        uint32_t value = 0;
+
+        if (reader->encoding == ENCODING_RAW) {
+            if (end - p < 4) goto truncated;
+            memcpy(&value, p, sizeof(value));
+            p += 4;
+        } else {
+            int shift = 0;
+            while (p < end && (*p & 0x80) && shift < 28) {
+                value |= (uint32_t)(*p++ & 0x7f) << shift;
+                shift += 7;
+            }
+            if (p >= end) goto truncated;
+            value |= (uint32_t)(*p++) << shift;
+        }
+        if (value >= reader->numPages) {
+            fprintf(stderr, "[ERRO] trace binario com indice de página inválido.\n");
+            return -1;
+        }
+        reader->start = (const char*)p - reader->buffer;
+        reader->remaining--;
+        if (reader->remap) {
+            value = reader->remap[value];
+            if (value == PAGE_NONE) {
+                reader->skipped++;
+                continue;
+            }
+        }
+        out[count++].page = value;
+    }
+    return count;
+
+truncated:
+    fprintf(stderr, "[ERRO] trace binario truncado.\n");
+    return -1;
+}
+
+// proximos acessos (ate maxAccesses), ja internados na tabela de paginas
+// no texto devolve o q ja tem antes de esperar mais dados do arquivo (um tracer lento nao segura o bloco)
+int traceReaderNext(TraceReader* reader, PageAccess* out, int maxAccesses) {
+    if (reader->binary) return readerNextBinary(reader, out, maxAccesses);
+
+    char buffer[MAX_PAGE_ID_LEN];
+    int count = 0;
+    while (count < maxAccesses) {
+        const char* line = reader->buffer + reader->start;
+        const char* newline = memchr(line, '\n', reader->end - reader->start);
+        const char* lineEnd = newline;
+
+        if (!newline) {
+            if (!reader->eof && (reader->start > 0 || reader->end < STREAM_BUFFER_SIZE)) {
+                if (count > 0) break;
+                if (readerFill(reader) < 0) return -1;
+                continue; // tenta de novo com o buffer completo
+            }
+            if (reader->start == reader->end) break; // acabou
+            lineEnd = reader->buffer + reader->end; // ultima linha sem '\n' ou linha maior q o buffer
+        }
+
+        if (!reader->skipLine) {
+            size_t len = parseTraceLine(&reader->parser, line, lineEnd, buffer, NULL);
+            if (len > 0 && !(len == 3 && memcmp(buffer, "...", 3) == 0)) {
+                // fora da amostra nem chega na tabela de paginas
+                if (pageSampled(buffer, reader->sampleThreshold)) out[count++].page = registerPage(buffer);
+                else reader->skipped++;
+            }
+        }
+        reader->skipLine = (!newline && !reader->eof); // resto da linha gigante vem no proximo read
+        reader->start = newline ? (size_t)(newline + 1 - reader->buffer) : reader->end;
+    }
+    return count;
+}
+
+void traceReaderClose(TraceReader* reader) {
+    if (reader->fd > STDIN_FILENO) close(reader->fd);
+    free(reader->buffer);
+    free(reader->remap);
+    reader->buffer = NULL;
+    reader->remap = NULL;
+}
+
+// grava trace (ja carregado e internado) no formato binario; compact = varint em vez de uint32
+int writeBinaryTrace(const char* filename, const Trace* trace, int compact) {
+    FILE* out = fopen(filename, "wb");
+    if (!out) return -1;
+
+    BinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+    header.version = BINARY_VERSION;
+    header.encoding = compact ? ENCODING_VARINT : ENCODING_RAW;
+    header.numPages = (uint32_t)g_pageCount;
+    header.numAccesses = (uint64_t)trace->numAccesses;
+
+    if (compact) {
+        for (int i = 0; i < trace->numAccesses; i++) {
+            uint32_t value = trace->accesses[i].page;
+            do { header.streamBytes++; value >>= 7; } while (value);
+        }
+    } else {
+        header.streamBytes = (uint64_t)trace->numAccesses * sizeof(PageAccess);
+    }
+    fwrite(&header, sizeof(header), 1, out);
+
+    // dicionario: um id por indice denso, preenchido com '\0'
+    char name[MAX_PAGE_ID_LEN];
+    for (int p = 0; p < g_pageCount; p++) {
+        memset(name, 0, sizeof(name));
+        strcpy(name, pageName(p));
+        fwrite(name, sizeof(name), 1, out);
+    }
+    size_t padding = streamOffset(header.numPages) - (sizeof(header) + (size_t)g_pageCount * MAX_PAGE_ID_LEN);
+    static const char zeros[4] = {0};
+    fwrite(zeros, 1, padding, out);
+
+    if (compact) {
+        unsigned char buffer[8192];
+        size_t used = 0;
+        for (int i = 0; i < trace->numAccesses; i++) {
+            uint32_t value = trace->accesses[i].page;
+            if (used + 5 > sizeof(buffer)) {
+                fwrite(buffer, 1, used, out);
+                used = 0;
+            }
+            while (value >= 0x80) {
+                buffer[used++] = (unsigned char)(value | 0x80);
+                value >>= 7;
+            }
+            buffer[used++] = (unsigned char)value;
+        }
+        fwrite(buffer, 1, used, out);
+    } else {
+        fwrite(trace->accesses, sizeof(PageAccess), trace->numAccesses, out);
+    }
+
+    if (ferror(out)) {
+        fclose(out);
+        return -1;
+    }
+    return fclose(out) == 0 ? 0 : -1;
+}
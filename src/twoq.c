@@ -0,0 +1,131 @@
+#include "simulator.h"
+
+// 2Q (Johnson & Shasha, versao completa): A1in = fila FIFO das pags vistas uma vez,
+// A1out = fantasmas expulsos de A1in, Am = LRU das pags reacessadas
+// Kin = 25% e Kout = 50% dos frames, como sugerido no artigo
+
+enum { TWOQ_NONE, TWOQ_A1IN, TWOQ_A1OUT, TWOQ_AM };
+
+typedef struct {
+    PageLinks links;
+    unsigned char* where;
+    PageList a1in, a1out, am;
+    int kin;
+    int kout;
+    int promote; // a pag q ta entrando tava em A1out (decidido antes de mexer nos fantasmas)
+} TwoQState;
+
+static void* twoQCreate(int numFrames, int numPages) {
+    TwoQState* state = (TwoQState*)policyAlloc(1, sizeof(TwoQState));
+    pageLinksInit(&state->links, numPages);
+    state->where = (unsigned char*)policyAlloc(numPages, sizeof(unsigned char));
+    pageListInit(&state->a1in);
+    pageListInit(&state->a1out);
+    pageListInit(&state->am);
+    state->kin = (numFrames / 4 > 0) ? numFrames / 4 : 1;
+    state->kout = (numFrames / 2 > 0) ? numFrames / 2 : 1;
+    return state;
+}
+
+static PageList* twoQList(TwoQState* state, int which) {
+    switch (which) {
+        case TWOQ_A1IN: return &state->a1in;
+        case TWOQ_A1OUT: return &state->a1out;
+        default: return &state->am;
+    }
+}
+
+static void twoQMove(TwoQState* state, uint32_t page, int to) {
+    if (state->where[page] != TWOQ_NONE) pageListRemove(twoQList(state, state->where[page]), &state->links, page);
+    state->where[page] = to;
+    if (to != TWOQ_NONE) pageListPushFront(twoQList(state, to), &state->links, page);
+}
+
+// hit em Am renova a posicao; hit em A1in nao muda nada (correlated references)
+static void twoQOnHit(void* raw, uint32_t page, int slot, long long nextUse) {
+    TwoQState* state = (TwoQState*)raw;
+    if (state->where[page] == TWOQ_AM) twoQMove(state, page, TWOQ_AM);
+}
+
+static uint32_t twoQChooseVictim(void* raw, uint32_t page) {
+    TwoQState* state = (TwoQState*)raw;
+
+    if (state->where[page] == TWOQ_A1OUT) {
+        twoQMove(state, page, TWOQ_NONE);
+        state->promote = 1;
+    }
+
+    if (state->a1in.size > state->kin || state->am.size == 0) {
+        uint32_t victim = state->a1in.tail;
+        twoQMove(state, victim, TWOQ_A1OUT);
+        if (state->a1out.size > state->kout) {
+            uint32_t old = pageListPopBack(&state->a1out, &state->links);
+            state->where[old] = TWOQ_NONE;
+        }
+        return victim;
+    }
+
+    uint32_t victim = state->am.tail;
+    twoQMove(state, victim, TWOQ_NONE);
+    return victim;
+}
+
+static void twoQOnMiss(void* raw, uint32_t page, int slot, long long nextUse) {
+    TwoQState* state = (TwoQState*)raw;
+    int reused = state->promote || state->where[page] == TWOQ_A1OUT;
+    state->promote = 0;
+    twoQMove(state, page, reused ? TWOQ_AM : TWOQ_A1IN);
+}
+
+static void twoQDestroy(void* raw) {
+    TwoQState* state = (TwoQState*)raw;
+    pageLinksFree(&state->links);
+    free(state->where);
+    free(state);
+}
+
+static void twoQGrow(void* raw, int oldPages, int numPages) {
+    TwoQState* state = (TwoQState*)raw;
+    pageLinksGrow(&state->links, oldPages, numPages);
+    state->where = (unsigned char*)policyRealloc(state->where, oldPages, numPages, sizeof(unsigned char));
+}
+
+static void twoQSave(void* raw, int usedFrames, int numPages, FILE* out) {
+    TwoQState* state = (TwoQState*)raw;
+    PageList lists[3] = { state->a1in, state->a1out, state->am };
+    checkpointWrite(out, lists, sizeof(lists));
+    checkpointWrite(out, &state->promote, sizeof(int));
+    checkpointWrite(out, state->where, numPages);
+    pageLinksSave(&state->links, numPages, out);
+}
+
+static int twoQRestore(void* raw, int usedFrames, int numPages, const int* slotOf, FILE* in) {
+    TwoQState* state = (TwoQState*)raw;
+    PageList lists[3];
+    if (checkpointRead(in, lists, sizeof(lists)) != 0 || checkpointRead(in, &state->promote, sizeof(int)) != 0) return -1;
+    state->a1in = lists[0];
+    state->a1out = lists[1];
+    state->am = lists[2];
+    if (checkpointRead(in, state->where, numPages) != 0) return -1;
+    if (pageLinksRestore(&state->links, numPages, in) != 0) return -1;
+
+    // A1in e Am tem exatamente as residentes; A1out so fantasmas. o where de cada pag bate com a lista dela
+    int inList[TWOQ_AM + 1] = { 0 };
+    for (int p = 0; p < numPages; p++) {
+        if (state->where[p] > TWOQ_AM) return -1;
+        inList[state->where[p]]++;
+    }
+    for (int which = TWOQ_A1IN; which <= TWOQ_AM; which++) {
+        const PageList* list = twoQList(state, which);
+        if (list->size != inList[which] ||
+            pageListCheck(list, &state->links, numPages, numPages, slotOf, which != TWOQ_A1OUT, state->where, which) != 0) {
+            return -1;
+        }
+    }
+    return (state->a1in.size + state->am.size == usedFrames) ? 0 : -1;
+}
+
+const ReplacementPolicy twoQPolicy = {
+    "2q", "2Q", 0, twoQCreate, twoQOnHit, twoQChooseVictim, twoQOnMiss, twoQDestroy, NULL, twoQGrow,
+    twoQSave, twoQRestore
+};
@@ -4,20 +4,20 @@ int g_verbose = 0;
 int g_didaticMode = 0;
 
 // exibe o estado atual dos frames na memória
-void displayFrameState(const char* algo, int num_pages, char** frames, const char* page_id, const char* pageToReplace, int slotIndex) {
-    printf("[didático:%s] page fault ('%s'): ", algo, page_id);
+void displayFrameState(const char* algo, int num_pages, const uint32_t* frames, uint32_t page, uint32_t pageToReplace, int slotIndex) {
+    printf("[didático:%s] page fault ('%s'): ", algo, pageName(page));
 
-    if (pageToReplace == NULL) { // entrou em um espaçõ vazio. insere normal
+    if (pageToReplace == PAGE_NONE) { // entrou em um espaçõ vazio. insere normal
         printf("página inserida no slot %d.", slotIndex);
     } else {
         // substitui um slot usado
-        printf("página '%s' foi substituída por '%s' no slot %d.", pageToReplace, page_id, slotIndex);
+        printf("página '%s' foi substituída por '%s' no slot %d.", pageName(pageToReplace), pageName(page), slotIndex);
     }
 
     printf(" memória atual: [");
     for (int i = 0; i < num_pages; i++) {
-        if (frames[i]) {
-            printf(" %s ", frames[i]);
+        if (frames[i] != PAGE_NONE) {
+            printf(" %s ", pageName(frames[i]));
         } else {
             printf(" --- ");
         }
@@ -40,3 +40,53 @@ long long parseMemorySize(const char * sizeStr) {
     if(strcmp(unit, "b") == 0) return value;
     return -1; // unidade desconhecida
 }
+
+
+static int compareInts(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// converte uma lista "8KB,16KB,1MB" em qtde de frames, ordenada e sem repetidos
+// retorna quantos tamanhos foram lidos ou -1 se algum for invalido
+int parseFrameList(const char* list, int** frameCounts) {
+    int capacity = 8, count = 0;
+    int* frames = (int*)malloc(capacity * sizeof(int));
+    char item[32];
+
+    while (*list) {
+        size_t len = strcspn(list, ",");
+        if (len == 0 || len >= sizeof(item)) {
+            free(frames);
+            return -1;
+        }
+        memcpy(item, list, len);
+        item[len] = '\0';
+        list += len;
+        if (*list == ',') list++;
+
+        long long bytes = parseMemorySize(item);
+        if (bytes < g_pageSize) {
+            free(frames);
+            return -1;
+        }
+        if (count >= capacity) {
+            capacity *= 2;
+            frames = (int*)realloc(frames, capacity * sizeof(int));
+        }
+        frames[count++] = (int)(bytes / g_pageSize);
+    }
+    if (count == 0) {
+        free(frames);
+        return -1;
+    }
+
+    qsort(frames, count, sizeof(int), compareInts);
+    int unique = 1;
+    for (int i = 1; i < count; i++) {
+        if (frames[i] != frames[unique - 1]) frames[unique++] = frames[i];
+    }
+
+    *frameCounts = frames;
+    return unique;
+}
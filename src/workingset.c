@@ -0,0 +1,158 @@
+#include "simulator.h"
+
+// working set de Denning e page fault frequency (--ws), numa passada so sobre a sequencia
+//
+// W(t, tau) = pags distintas nos ultimos tau acessos. com o ultimo acesso de cada pag (lastAccess, indexado
+// pelo indice denso da tabela de paginas) a janela anda em O(1): a pag de agora entra se o ultimo acesso dela
+// ja tinha saido da janela, e a pag do acesso t - tau sai se aquele foi o ultimo acesso dela (e se nao eh a
+// pag de agora). uma pag q entra no W eh uma falta da politica working set
+//
+// PFF (Chu e Opderbeck) com limiar T: numa falta, se passaram mais de T acessos desde a falta anterior,
+// saem todas as pags residentes nao referenciadas desde aquela falta; senao o conjunto residente so cresce.
+// as residentes ficam numa lista em ordem de uso, entao as nao referenciadas sao um sufixo da lista e cada
+// pag eh tirada uma vez so (O(1) amortizado). o T de cada coluna eh o mesmo tau do working set
+//
+// a serie temporal agrupa os acessos em blocos (pontos do csv): media e pico do W, faltas do working set,
+// media do conjunto residente do PFF e faltas do PFF em cada bloco
+
+typedef struct {
+    int tau;
+    // working set
+    int size;
+    int peak;
+    long long faults;
+    long long sum;        // soma do W em todos os acessos (media no fim)
+    long long aboveMemory; // acessos com W maior q a memoria
+    // PFF
+    PageLinks links;
+    PageList resident;    // mais recente na frente
+    unsigned char* isResident;
+    int lastFault;        // -1 = nenhuma ainda
+    int pffPeak;
+    long long pffFaults;
+    long long pffSum;
+    // bloco atual da serie
+    long long blockSum;
+    int blockPeak;
+    long long blockFaults;
+    long long blockPffSum;
+    long long blockPffFaults;
+} WindowState;
+
+// falta do PFF no acesso t: encolhe (se a ultima falta foi ha mais de T acessos) e poe a pag
+static void pffFault(WindowState* w, const int* lastAccess, uint32_t page, int t) {
+    if (w->lastFault >= 0 && t - w->lastFault > w->tau) {
+        while (w->resident.size > 0 && lastAccess[w->resident.tail] < w->lastFault) {
+            uint32_t old = pageListPopBack(&w->resident, &w->links);
+            w->isResident[old] = 0;
+        }
+    }
+    pageListPushFront(&w->resident, &w->links, page);
+    w->isResident[page] = 1;
+    w->lastFault = t;
+    w->pffFaults++;
+    w->blockPffFaults++;
+}
+
+int runWorkingSetAnalysis(const PageAccess* accessSequence, int numAccesses, const int* taus, int numTaus, int numFrames,
+                          int points, const char* outPath) {
+    FILE* out = fopen(outPath, "w");
+    if (!out) {
+        perror("[ERRO] ao criar o csv do working set");
+        return -1;
+    }
+    int numPages = g_pageCount;
+    int* lastAccess = (int*)policyAlloc(numPages > 0 ? numPages : 1, sizeof(int));
+    for (int p = 0; p < numPages; p++) lastAccess[p] = -1;
+
+    WindowState* windows = (WindowState*)policyAlloc(numTaus, sizeof(WindowState));
+    fprintf(out, "acesso");
+    for (int k = 0; k < numTaus; k++) {
+        WindowState* w = &windows[k];
+        w->tau = taus[k];
+        w->lastFault = -1;
+        pageLinksInit(&w->links, numPages);
+        pageListInit(&w->resident);
+        w->isResident = (unsigned char*)policyAlloc(numPages > 0 ? numPages : 1, sizeof(unsigned char));
+        fprintf(out, ",ws%d_medio,ws%d_pico,ws%d_faltas,pff%d_medio,pff%d_faltas", w->tau, w->tau, w->tau, w->tau, w->tau);
+    }
+    fprintf(out, "\n");
+
+    int blockSize = (numAccesses + points - 1) / points;
+    if (blockSize < 1) blockSize = 1;
+    int blockStart = 0;
+    for (int t = 0; t < numAccesses; t++) {
+        uint32_t page = accessSequence[t].page;
+        int last = lastAccess[page];
+        for (int k = 0; k < numTaus; k++) {
+            WindowState* w = &windows[k];
+            int leaving = t - w->tau; // acesso q sai da janela agora
+            // a janela antes de t cobre leaving..t-1: a pag so entra se o ultimo acesso dela ficou antes disso
+            if (last < 0 || last < leaving) {
+                w->size++;
+                w->faults++;
+                w->blockFaults++;
+            }
+            // a pag q sai nao sai se for a de agora (o ultimo acesso dela passa a ser t)
+            uint32_t leavingPage = (leaving >= 0) ? accessSequence[leaving].page : PAGE_NONE;
+            if (leavingPage != PAGE_NONE && leavingPage != page && lastAccess[leavingPage] == leaving) w->size--;
+            if (w->size > w->peak) w->peak = w->size;
+            if (w->size > w->blockPeak) w->blockPeak = w->size;
+            if (w->size > numFrames) w->aboveMemory++;
+            w->sum += w->size;
+            w->blockSum += w->size;
+
+            if (w->isResident[page]) {
+                if (w->resident.head != page) {
+                    pageListRemove(&w->resident, &w->links, page);
+                    pageListPushFront(&w->resident, &w->links, page);
+                }
+            } else {
+                pffFault(w, lastAccess, page, t);
+            }
+            if (w->resident.size > w->pffPeak) w->pffPeak = w->resident.size;
+            w->pffSum += w->resident.size;
+            w->blockPffSum += w->resident.size;
+        }
+        lastAccess[page] = t;
+
+        // fim do bloco: uma linha da serie
+        if (t + 1 - blockStart == blockSize || t + 1 == numAccesses) {
+            int count = t + 1 - blockStart;
+            fprintf(out, "%d", t + 1);
+            for (int k = 0; k < numTaus; k++) {
+                WindowState* w = &windows[k];
+                fprintf(out, ",%.1f,%d,%lld,%.1f,%lld", (double)w->blockSum / count, w->blockPeak, w->blockFaults,
+                        (double)w->blockPffSum / count, w->blockPffFaults);
+                w->blockSum = w->blockFaults = w->blockPffSum = w->blockPffFaults = 0;
+                w->blockPeak = 0;
+            }
+            fprintf(out, "\n");
+            blockStart = t + 1;
+        }
+    }
+    int failed = ferror(out);
+    if (fclose(out) != 0) failed = 1;
+    if (failed) perror("[ERRO] ao gravar o csv do working set");
+
+    printf("\nRELATÓRIO (working set e PFF):\n");
+    printf("%d acessos, %d páginas distintas; a memória física comporta %d páginas.\n", numAccesses, numPages, numFrames);
+    printf("\n%-10s %10s %10s %12s %8s %12s %10s %10s %12s %8s\n", "tau", "ws médio", "ws pico", "faltas ws", "taxa",
+           "acima mem.", "pff médio", "pff pico", "faltas pff", "taxa");
+    for (int i = 0; i < 10 + 11 * 2 + 13 + 9 + 13 + 11 * 2 + 13 + 9; i++) putchar('-');
+    printf("\n");
+    for (int k = 0; k < numTaus; k++) {
+        WindowState* w = &windows[k];
+        double n = numAccesses ? (double)numAccesses : 1.0;
+        printf("%-10d %10.1f %10d %12lld %7.2f%% %11.1f%% %10.1f %10d %12lld %7.2f%%\n", w->tau, w->sum / n, w->peak, w->faults,
+               100.0 * w->faults / n, 100.0 * w->aboveMemory / n, w->pffSum / n, w->pffPeak, w->pffFaults,
+               100.0 * w->pffFaults / n);
+        pageLinksFree(&w->links);
+        free(w->isResident);
+    }
+    printf("\nsérie temporal (%d pontos de %d acessos) gravada em %s.\n", (numAccesses + blockSize - 1) / blockSize, blockSize, outPath);
+
+    free(windows);
+    free(lastAccess);
+    return failed ? -1 : 0;
+}